@@ -0,0 +1,504 @@
+// Замеры производительности контейнеров. Собирается отдельно от тестов с оптимизациями:
+//   g++ -std=c++17 -O2 -DNDEBUG -pthread benchmark.cpp -o benchmark && ./benchmark [max_size]
+// Сортировки замеряются до max_size элементов: ./benchmark 1000000000 требует около 12 ГиБ памяти
+// С -DVECTOR_BUFFER_CACHE буферы RawMemory переиспользуются через BufferCache,
+// с -DVECTOR_ADAPTIVE_CAPACITY начальная вместимость подбирается через CapacityAdvisor
+#include "bit_vector.h"
+#include "compressed_int_vector.h"
+#include "flat_hash_map.h"
+#include "flat_map.h"
+#include "parallel_vector_builder.h"
+#include "vector_sort.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+    // Не даёт компилятору выбросить результат замеряемого кода
+    volatile uint64_t benchmark_sink = 0;
+
+    // Среднее время одной операции в наносекундах
+    template <typename Func>
+    double MeasureNsPerOp(size_t operations, Func func) {
+        const auto start = std::chrono::steady_clock::now();
+        func();
+        const auto finish = std::chrono::steady_clock::now();
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(finish - start).count();
+        return operations == 0 ? 0.0 : static_cast<double>(ns) / static_cast<double>(operations);
+    }
+
+    void PrintResult(const std::string& name, size_t size, double ns_per_op) {
+        std::cout << std::setw(36) << std::left << name << std::setw(12) << std::right << size
+            << std::setw(12) << std::fixed << std::setprecision(1) << ns_per_op << " ns/op" << std::endl;
+    }
+
+    Vector<uint64_t> RandomKeys(size_t count, uint64_t seed) {
+        std::mt19937_64 generator(seed);
+        Vector<uint64_t> keys;
+        keys.Reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            keys.PushBack(generator());
+        }
+        return keys;
+    }
+
+    constexpr size_t LOOKUPS = 1'000'000;
+
+    template <typename Map, typename Find>
+    void BenchmarkLookup(const std::string& name, const Map& map, const Vector<uint64_t>& keys, Find find) {
+        std::mt19937_64 generator(42);
+        Vector<uint64_t> queries;
+        queries.Reserve(LOOKUPS);
+        for (size_t i = 0; i < LOOKUPS; ++i) {
+            queries.PushBack(keys[generator() % keys.Size()]);
+        }
+        const double ns = MeasureNsPerOp(LOOKUPS, [&] {
+            uint64_t sum = 0;
+            for (uint64_t key : queries) {
+                sum += find(map, key);
+            }
+            benchmark_sink = sum;
+        });
+        PrintResult(name, keys.Size(), ns);
+    }
+
+    void BenchmarkFlatMap(size_t size) {
+        const Vector<uint64_t> keys = RandomKeys(size, size);
+
+        FlatMap<uint64_t, uint64_t> flat_map;
+        std::map<uint64_t, uint64_t> tree_map;
+        std::unordered_map<uint64_t, uint64_t> hash_map;
+        Vector<std::pair<uint64_t, uint64_t>> items;
+        items.Reserve(size);
+        for (uint64_t key : keys) {
+            items.EmplaceBack(key, key);
+        }
+        const double flat_insert = MeasureNsPerOp(size, [&] {
+            flat_map.InsertRange(items.begin(), items.end());
+        });
+        PrintResult("FlatMap::InsertRange", size, flat_insert);
+        const double tree_insert = MeasureNsPerOp(size, [&] {
+            tree_map.insert(items.begin(), items.end());
+        });
+        PrintResult("std::map::insert", size, tree_insert);
+        const double hash_insert = MeasureNsPerOp(size, [&] {
+            hash_map.insert(items.begin(), items.end());
+        });
+        PrintResult("std::unordered_map::insert", size, hash_insert);
+
+        BenchmarkLookup("FlatMap::Find", flat_map, keys, [](const auto& map, uint64_t key) {
+            return *map.Find(key);
+        });
+        BenchmarkLookup("std::map::find", tree_map, keys, [](const auto& map, uint64_t key) {
+            return map.find(key)->second;
+        });
+        BenchmarkLookup("std::unordered_map::find", hash_map, keys, [](const auto& map, uint64_t key) {
+            return map.find(key)->second;
+        });
+    }
+
+    void BenchmarkFlatHashMap(size_t size) {
+        const Vector<uint64_t> keys = RandomKeys(size, size);
+
+        FlatHashMap<uint64_t, uint64_t> flat_map;
+        std::unordered_map<uint64_t, uint64_t> hash_map;
+        const double flat_insert = MeasureNsPerOp(size, [&] {
+            for (uint64_t key : keys) {
+                flat_map.Insert(key, key);
+            }
+        });
+        PrintResult("FlatHashMap::Insert", size, flat_insert);
+        const double hash_insert = MeasureNsPerOp(size, [&] {
+            for (uint64_t key : keys) {
+                hash_map.emplace(key, key);
+            }
+        });
+        PrintResult("std::unordered_map::emplace", size, hash_insert);
+
+        BenchmarkLookup("FlatHashMap::Find", flat_map, keys, [](const auto& map, uint64_t key) {
+            return *map.Find(key);
+        });
+        BenchmarkLookup("std::unordered_map::find", hash_map, keys, [](const auto& map, uint64_t key) {
+            return map.find(key)->second;
+        });
+
+        const double flat_erase = MeasureNsPerOp(size, [&] {
+            for (uint64_t key : keys) {
+                flat_map.Erase(key);
+            }
+        });
+        PrintResult("FlatHashMap::Erase", size, flat_erase);
+        const double hash_erase = MeasureNsPerOp(size, [&] {
+            for (uint64_t key : keys) {
+                hash_map.erase(key);
+            }
+        });
+        PrintResult("std::unordered_map::erase", size, hash_erase);
+    }
+
+    // Заполнение, побитовое И, подсчёт и перебор установленных битов
+    void BenchmarkBitVector(size_t size) {
+        std::mt19937_64 generator(size);
+        BitVector lhs(size);
+        BitVector rhs(size);
+        std::vector<bool> std_lhs(size);
+        std::vector<bool> std_rhs(size);
+        for (size_t i = 0; i < size; ++i) {
+            const uint64_t random = generator();
+            lhs[i] = std_lhs[i] = random % 3 == 0;
+            rhs[i] = std_rhs[i] = random % 5 == 0;
+        }
+
+        PrintResult("BitVector::PushBack", size, MeasureNsPerOp(size, [&] {
+            BitVector bits;
+            for (size_t i = 0; i < size; ++i) {
+                bits.PushBack(i % 3 == 0);
+            }
+            benchmark_sink = bits.Size();
+        }));
+        PrintResult("std::vector<bool>::push_back", size, MeasureNsPerOp(size, [&] {
+            std::vector<bool> bits;
+            for (size_t i = 0; i < size; ++i) {
+                bits.push_back(i % 3 == 0);
+            }
+            benchmark_sink = bits.size();
+        }));
+        PrintResult("Vector<bool>::PushBack", size, MeasureNsPerOp(size, [&] {
+            Vector<bool> bits;
+            for (size_t i = 0; i < size; ++i) {
+                bits.PushBack(i % 3 == 0);
+            }
+            benchmark_sink = bits.Size();
+        }));
+
+        PrintResult("BitVector &= and Count", size, MeasureNsPerOp(size, [&] {
+            BitVector bits(lhs);
+            bits &= rhs;
+            benchmark_sink = bits.Count();
+        }));
+        PrintResult("std::vector<bool> and + count", size, MeasureNsPerOp(size, [&] {
+            std::vector<bool> bits(std_lhs);
+            uint64_t count = 0;
+            for (size_t i = 0; i < size; ++i) {
+                bits[i] = bits[i] && std_rhs[i];
+                count += bits[i];
+            }
+            benchmark_sink = count;
+        }));
+
+        PrintResult("BitVector::FindNext scan", size, MeasureNsPerOp(size, [&] {
+            uint64_t sum = 0;
+            for (size_t i = rhs.FindFirst(); i < rhs.Size(); i = rhs.FindNext(i + 1)) {
+                sum += i;
+            }
+            benchmark_sink = sum;
+        }));
+        PrintResult("std::vector<bool> scan", size, MeasureNsPerOp(size, [&] {
+            uint64_t sum = 0;
+            for (size_t i = 0; i < size; ++i) {
+                if (std_rhs[i]) {
+                    sum += i;
+                }
+            }
+            benchmark_sink = sum;
+        }));
+    }
+
+    // Распаковка отсортированных идентификаторов против чтения несжатого Vector<uint32_t>
+    void BenchmarkCompressedIntVector(size_t size) {
+        std::mt19937_64 generator(size);
+        Vector<uint32_t> ids;
+        CompressedIntVector<uint32_t> compressed;
+        CompressedIntVector<uint32_t> deltas(CompressedIntVector<uint32_t>::Encoding::DELTA);
+        ids.Reserve(size);
+        uint32_t id = 0;
+        for (size_t i = 0; i < size; ++i) {
+            id += static_cast<uint32_t>(generator() % 64);
+            ids.PushBack(id);
+            compressed.PushBack(id);
+            deltas.PushBack(id);
+        }
+        std::cout << "CompressedIntVector ratio for " << size << " sorted ids: " << std::setprecision(2)
+            << compressed.CompressionRatio() << ", delta: " << deltas.CompressionRatio() << std::endl;
+
+        PrintResult("Vector<uint32_t> scan", size, MeasureNsPerOp(size, [&] {
+            uint64_t sum = 0;
+            for (uint32_t value : ids) {
+                sum += value;
+            }
+            benchmark_sink = sum;
+        }));
+        PrintResult("CompressedIntVector scan", size, MeasureNsPerOp(size, [&] {
+            uint64_t sum = 0;
+            for (uint32_t value : compressed) {
+                sum += value;
+            }
+            benchmark_sink = sum;
+        }));
+        PrintResult("CompressedIntVector::ForEach", size, MeasureNsPerOp(size, [&] {
+            uint64_t sum = 0;
+            compressed.ForEach([&sum](uint32_t value) {
+                sum += value;
+            });
+            benchmark_sink = sum;
+        }));
+        PrintResult("CompressedIntVector::ForEach, delta", size, MeasureNsPerOp(size, [&] {
+            uint64_t sum = 0;
+            deltas.ForEach([&sum](uint32_t value) {
+                sum += value;
+            });
+            benchmark_sink = sum;
+        }));
+
+        Vector<size_t> positions;
+        positions.Reserve(LOOKUPS);
+        for (size_t i = 0; i < LOOKUPS; ++i) {
+            positions.PushBack(generator() % size);
+        }
+        PrintResult("Vector<uint32_t> random access", size, MeasureNsPerOp(LOOKUPS, [&] {
+            uint64_t sum = 0;
+            for (size_t position : positions) {
+                sum += ids[position];
+            }
+            benchmark_sink = sum;
+        }));
+        PrintResult("CompressedIntVector random access", size, MeasureNsPerOp(LOOKUPS, [&] {
+            uint64_t sum = 0;
+            for (size_t position : positions) {
+                sum += compressed[position];
+            }
+            benchmark_sink = sum;
+        }));
+        PrintResult("CompressedIntVector random, delta", size, MeasureNsPerOp(LOOKUPS, [&] {
+            uint64_t sum = 0;
+            for (size_t position : positions) {
+                sum += deltas[position];
+            }
+            benchmark_sink = sum;
+        }));
+    }
+
+    template <typename T, typename Sort>
+    void BenchmarkSortOf(const std::string& name, const Vector<T>& input, Sort sort) {
+        Vector<T> values(input);
+        const double ns = MeasureNsPerOp(values.Size(), [&] {
+            sort(values);
+        });
+        benchmark_sink = values.Size();
+        PrintResult(name, values.Size(), ns);
+    }
+
+    // Поразрядная и параллельная сортировка против std::sort
+    void BenchmarkSort(size_t size) {
+        std::mt19937_64 generator(size);
+        Vector<uint32_t> integers;
+        Vector<float> floats;
+        integers.Reserve(size);
+        floats.Reserve(size);
+        for (size_t i = 0; i < size; ++i) {
+            integers.PushBack(static_cast<uint32_t>(generator()));
+            floats.PushBack(static_cast<float>(static_cast<int32_t>(generator())) / 1024.0f);
+        }
+        RawMemory<uint32_t> integer_scratch;
+        RawMemory<float> float_scratch;
+
+        BenchmarkSortOf("std::sort uint32_t", integers, [](Vector<uint32_t>& values) {
+            std::sort(values.begin(), values.end());
+        });
+        BenchmarkSortOf("RadixSort uint32_t", integers, [&](Vector<uint32_t>& values) {
+            RadixSort(values, integer_scratch);
+        });
+        BenchmarkSortOf("ParallelSort uint32_t", integers, [](Vector<uint32_t>& values) {
+            ParallelSort(values);
+        });
+        BenchmarkSortOf("std::sort float", floats, [](Vector<float>& values) {
+            std::sort(values.begin(), values.end());
+        });
+        BenchmarkSortOf("RadixSort float", floats, [&](Vector<float>& values) {
+            RadixSort(values, float_scratch);
+        });
+
+        // Записи сортируются по 32-битному ключу
+        using Record = std::pair<uint32_t, uint64_t>;
+        Vector<Record> records;
+        records.Reserve(size);
+        for (size_t i = 0; i < size; ++i) {
+            records.EmplaceBack(integers[i], i);
+        }
+        BenchmarkSortOf("std::sort records by key", records, [](Vector<Record>& values) {
+            std::sort(values.begin(), values.end(), [](const Record& lhs, const Record& rhs) {
+                return lhs.first < rhs.first;
+            });
+        });
+        BenchmarkSortOf("RadixSortBy records", records, [](Vector<Record>& values) {
+            RadixSortBy(values, [](const Record& record) { return record.first; });
+        });
+    }
+
+    // Склейка частей, заполненных потоками: PushBack всех элементов в один вектор
+    // против ParallelVectorBuilder::Finish с разным числом потоков
+    template <typename T, typename Make>
+    void BenchmarkParallelBuildOf(const std::string& name, size_t size, Make make) {
+        const size_t CHUNKS = 8;
+        ParallelVectorBuilder<T> builder(CHUNKS);
+        const auto fill = [&] {
+            for (size_t chunk = 0; chunk < CHUNKS; ++chunk) {
+                builder.Chunk(chunk).Clear();
+            }
+            for (size_t i = 0; i < size; ++i) {
+                builder.Chunk(i % CHUNKS).PushBack(make(i));
+            }
+        };
+        fill();
+        PrintResult("concat PushBack " + name, size, MeasureNsPerOp(size, [&] {
+            Vector<T> result;
+            for (size_t chunk = 0; chunk < CHUNKS; ++chunk) {
+                for (T& value : builder.Chunk(chunk)) {
+                    result.PushBack(std::move(value));
+                }
+            }
+            benchmark_sink = result.Size();
+        }));
+        fill();
+        // Склейка с заранее выделенной памятью отличается от Finish только числом потоков
+        PrintResult("concat Reserve " + name, size, MeasureNsPerOp(size, [&] {
+            Vector<T> result;
+            result.Reserve(builder.Size());
+            for (size_t chunk = 0; chunk < CHUNKS; ++chunk) {
+                for (T& value : builder.Chunk(chunk)) {
+                    result.PushBack(std::move(value));
+                }
+            }
+            benchmark_sink = result.Size();
+        }));
+        for (size_t threads = 1; threads <= CHUNKS; threads *= 2) {
+            fill();
+            PrintResult("Finish x" + std::to_string(threads) + " " + name, size, MeasureNsPerOp(size, [&] {
+                benchmark_sink = builder.Finish(threads).Size();
+            }));
+        }
+    }
+
+    void BenchmarkParallelBuild(size_t size) {
+        BenchmarkParallelBuildOf<uint64_t>("uint64_t", size, [](size_t i) {
+            return static_cast<uint64_t>(i) * 0x9E3779B97F4A7C15ull;
+        });
+        BenchmarkParallelBuildOf<std::string>("std::string", size, [](size_t i) {
+            return std::to_string(i);
+        });
+    }
+
+    // Обработчики запросов многократно строят и освобождают векторы похожих размеров
+    void BenchmarkBufferChurn(const std::string& name, size_t elements, size_t rounds) {
+        const double ns = MeasureNsPerOp(rounds, [&] {
+            uint64_t sum = 0;
+            for (size_t round = 0; round < rounds; ++round) {
+                Vector<uint64_t> v;
+                for (size_t i = 0; i < elements; ++i) {
+                    v.PushBack(i);
+                }
+                sum += v[round % elements];
+            }
+            benchmark_sink = sum;
+        });
+        PrintResult(name, elements, ns);
+    }
+
+    // Небольшие буферы malloc переиспользует сам, а буферы от сотен килобайт
+    // выделяет через mmap: кеш выигрывает только на них
+    void BenchmarkBufferChurnSizes(const std::string& name) {
+        BenchmarkBufferChurn(name, 300, 100'000);
+        BenchmarkBufferChurn(name, size_t{ 1 } << 16, 300);
+    }
+
+    void BenchmarkBufferCache() {
+#ifdef VECTOR_BUFFER_CACHE
+        BufferCache& cache = BufferCache::Local();
+        const size_t limit = cache.ByteLimit();
+        cache.SetByteLimit(0);
+        BufferCache::SetSharedByteLimit(0);
+        BenchmarkBufferChurnSizes("Vector churn, cache disabled");
+        cache.SetByteLimit(limit);
+        BufferCache::SetSharedByteLimit(BufferCache::DEFAULT_SHARED_BYTE_LIMIT);
+        cache.ResetStats();
+        BenchmarkBufferChurnSizes("Vector churn, cache enabled");
+        std::cout << "BufferCache hit rate: " << cache.GetStats().HitRate() << std::endl;
+#else
+        BenchmarkBufferChurnSizes("Vector churn, operator new");
+#endif
+    }
+
+    // Заполняет векторы размерами из sizes; все векторы создаются в одном месте
+    void BenchmarkBatches(const std::string& name, const Vector<size_t>& sizes) {
+        size_t elements = 0;
+        for (size_t size : sizes) {
+            elements += size;
+        }
+        const double ns = MeasureNsPerOp(elements, [&] {
+            uint64_t sum = 0;
+            for (size_t size : sizes) {
+                Vector<uint64_t> batch;
+                for (size_t i = 0; i < size; ++i) {
+                    batch.PushBack(i);
+                }
+                sum += batch.Capacity();
+            }
+            benchmark_sink = sum;
+        });
+        PrintResult(name, sizes.Size(), ns);
+    }
+
+    template <typename Distribution>
+    Vector<size_t> RandomSizes(size_t count, Distribution distribution) {
+        std::mt19937_64 generator(count);
+        Vector<size_t> sizes;
+        sizes.Reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            sizes.PushBack(static_cast<size_t>(std::max(1.0, distribution(generator))));
+        }
+        return sizes;
+    }
+
+    void BenchmarkAdaptiveCapacity() {
+        constexpr size_t BATCHES = 100'000;
+        // Пакеты около 300 элементов и размеры с тяжёлым хвостом
+        const Vector<size_t> normal = RandomSizes(BATCHES, std::normal_distribution<double>(300.0, 30.0));
+        const Vector<size_t> lognormal = RandomSizes(BATCHES, std::lognormal_distribution<double>(5.0, 1.0));
+#ifdef VECTOR_ADAPTIVE_CAPACITY
+        CapacityAdvisor& advisor = CapacityAdvisor::Local();
+        advisor.SetMaxHintBytes(0);
+        BenchmarkBatches("Batches ~N(300), doubling", normal);
+        BenchmarkBatches("Batches ~LogN(5), doubling", lognormal);
+        advisor.SetMaxHintBytes(CapacityAdvisor::DEFAULT_MAX_HINT_BYTES);
+        BenchmarkBatches("Batches ~N(300), adaptive", normal);
+        BenchmarkBatches("Batches ~LogN(5), adaptive", lognormal);
+#else
+        BenchmarkBatches("Batches ~N(300), doubling", normal);
+        BenchmarkBatches("Batches ~LogN(5), doubling", lognormal);
+#endif
+    }
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t max_size = argc > 1 ? std::stoul(argv[1]) : 1'000'000;
+    BenchmarkBufferCache();
+    BenchmarkAdaptiveCapacity();
+    for (size_t size = 1'000; size <= max_size; size *= 10) {
+        BenchmarkFlatMap(size);
+        BenchmarkFlatHashMap(size);
+        BenchmarkBitVector(size);
+        BenchmarkCompressedIntVector(size);
+        BenchmarkSort(size);
+        BenchmarkParallelBuild(size);
+    }
+}
@@ -0,0 +1,426 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BIT_VECTOR_SSE2 1
+#endif
+
+namespace bit_vector_detail {
+
+    constexpr size_t WORD_BITS = 64;
+
+    inline size_t WordCount(size_t bits) noexcept {
+        return (bits + WORD_BITS - 1) / WORD_BITS;
+    }
+
+    inline size_t PopCount(uint64_t word) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<size_t>(__builtin_popcountll(word));
+#else
+        size_t count = 0;
+        for (; word != 0; word &= word - 1) {
+            ++count;
+        }
+        return count;
+#endif
+    }
+
+    inline size_t LowestBit(uint64_t word) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<size_t>(__builtin_ctzll(word));
+#else
+        size_t index = 0;
+        while ((word & 1) == 0) {
+            word >>= 1;
+            ++index;
+        }
+        return index;
+#endif
+    }
+
+    enum class BitOp {
+        AND,
+        OR,
+        XOR,
+    };
+
+    template <BitOp OP>
+    uint64_t Apply(uint64_t lhs, uint64_t rhs) noexcept {
+        if constexpr (OP == BitOp::AND) {
+            return lhs & rhs;
+        }
+        else if constexpr (OP == BitOp::OR) {
+            return lhs | rhs;
+        }
+        else {
+            return lhs ^ rhs;
+        }
+    }
+
+#ifdef BIT_VECTOR_SSE2
+    template <BitOp OP>
+    __m128i Apply(__m128i lhs, __m128i rhs) noexcept {
+        if constexpr (OP == BitOp::AND) {
+            return _mm_and_si128(lhs, rhs);
+        }
+        else if constexpr (OP == BitOp::OR) {
+            return _mm_or_si128(lhs, rhs);
+        }
+        else {
+            return _mm_xor_si128(lhs, rhs);
+        }
+    }
+#endif
+
+    // dst[i] = dst[i] OP src[i]; с SSE2 обрабатывается по два слова за инструкцию
+    template <BitOp OP>
+    void Combine(uint64_t* dst, const uint64_t* src, size_t count) noexcept {
+        size_t i = 0;
+#ifdef BIT_VECTOR_SSE2
+        for (; i + 2 <= count; i += 2) {
+            const __m128i lhs = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+            const __m128i rhs = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), Apply<OP>(lhs, rhs));
+        }
+#endif
+        for (; i < count; ++i) {
+            dst[i] = Apply<OP>(dst[i], src[i]);
+        }
+    }
+
+    inline void Invert(uint64_t* words, size_t count) noexcept {
+        size_t i = 0;
+#ifdef BIT_VECTOR_SSE2
+        const __m128i ones = _mm_set1_epi32(-1);
+        for (; i + 2 <= count; i += 2) {
+            const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(words + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(words + i), _mm_xor_si128(value, ones));
+        }
+#endif
+        for (; i < count; ++i) {
+            words[i] = ~words[i];
+        }
+    }
+
+    // Индекс первого ненулевого слова в [first, count) либо count
+    inline size_t FindNonZeroWord(const uint64_t* words, size_t first, size_t count) noexcept {
+        size_t i = first;
+#ifdef BIT_VECTOR_SSE2
+        const __m128i zero = _mm_setzero_si128();
+        for (; i + 2 <= count; i += 2) {
+            const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(words + i));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(value, zero)) != 0xFFFF) {
+                break;
+            }
+        }
+#endif
+        while (i < count && words[i] == 0) {
+            ++i;
+        }
+        return i;
+    }
+
+}  // namespace bit_vector_detail
+
+// Вектор битов, упакованных по 64 в слово: в восемь раз компактнее Vector<bool>.
+// Растёт как Vector — удвоением вместимости с переносом слов в новый буфер, поэтому
+// при нехватке памяти вектор остаётся прежним. Биты за пределами Size() в последнем
+// слове всегда нулевые, на этом держатся Count, FindNext и сравнение
+class BitVector {
+public:
+    // Ссылка на отдельный бит, возвращаемая неконстантным operator[]
+    class Reference {
+    public:
+        operator bool() const noexcept {
+            return (*word_ & mask_) != 0;
+        }
+
+        Reference& operator=(bool value) noexcept {
+            if (value) {
+                *word_ |= mask_;
+            }
+            else {
+                *word_ &= ~mask_;
+            }
+            return *this;
+        }
+
+        Reference& operator=(const Reference& other) noexcept {
+            return *this = static_cast<bool>(other);
+        }
+
+        void Flip() noexcept {
+            *word_ ^= mask_;
+        }
+
+    private:
+        friend class BitVector;
+
+        Reference(uint64_t* word, uint64_t mask) noexcept
+            : word_(word)
+            , mask_(mask) {
+        }
+
+        uint64_t* word_;
+        uint64_t mask_;
+    };
+
+    BitVector() = default;
+
+    explicit BitVector(size_t size, bool value = false) {
+        Resize(size, value);
+    }
+
+    BitVector(const BitVector& other)
+        : words_(WordCount(other.size_))
+        , size_(other.size_) {
+        if (size_ > 0) {
+            std::memcpy(words_.GetAddress(), other.words_.GetAddress(), WordCount(size_) * sizeof(uint64_t));
+        }
+    }
+
+    BitVector(BitVector&& other) noexcept
+        : words_(std::move(other.words_))
+        , size_(std::exchange(other.size_, 0)) {
+    }
+
+    BitVector& operator=(const BitVector& rhs) {
+        if (this != &rhs) {
+            if (rhs.size_ <= Capacity()) {
+                if (rhs.size_ > 0) {
+                    std::memcpy(words_.GetAddress(), rhs.words_.GetAddress(), WordCount(rhs.size_) * sizeof(uint64_t));
+                }
+                size_ = rhs.size_;
+            }
+            else {
+                BitVector rhs_copy(rhs);
+                Swap(rhs_copy);
+            }
+        }
+        return *this;
+    }
+
+    BitVector& operator=(BitVector&& rhs) noexcept {
+        if (this != &rhs) {
+            words_ = std::move(rhs.words_);
+            size_ = std::exchange(rhs.size_, 0);
+        }
+        return *this;
+    }
+
+    void Swap(BitVector& other) noexcept {
+        words_.Swap(other.words_);
+        std::swap(size_, other.size_);
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    // Вместимость в битах
+    size_t Capacity() const noexcept {
+        return words_.Capacity() * bit_vector_detail::WORD_BITS;
+    }
+
+    // Количество занятых слов и указатель на них, например для записи на диск
+    size_t WordsSize() const noexcept {
+        return WordCount(size_);
+    }
+
+    const uint64_t* Words() const noexcept {
+        return words_.GetAddress();
+    }
+
+    bool operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return (words_[WordIndex(index)] & BitMask(index)) != 0;
+    }
+
+    Reference operator[](size_t index) noexcept {
+        assert(index < size_);
+        return Reference(&words_[WordIndex(index)], BitMask(index));
+    }
+
+    void Reserve(size_t new_capacity) {
+        if (new_capacity > Capacity()) {
+            Reallocate(WordCount(new_capacity));
+        }
+    }
+
+    void Resize(size_t new_size, bool value = false) {
+        if (new_size <= size_) {
+            size_ = new_size;
+            ClearUnusedBits();
+            return;
+        }
+        Reserve(new_size);
+        const size_t used_words = WordCount(size_);
+        if (value && size_ % bit_vector_detail::WORD_BITS != 0) {
+            words_[used_words - 1] |= ~uint64_t{ 0 } << (size_ % bit_vector_detail::WORD_BITS);
+        }
+        std::fill(words_.GetAddress() + used_words, words_.GetAddress() + WordCount(new_size),
+            value ? ~uint64_t{ 0 } : uint64_t{ 0 });
+        size_ = new_size;
+        ClearUnusedBits();
+    }
+
+    void PushBack(bool value) {
+        if (size_ == Capacity()) {
+            Reallocate(words_.Capacity() == 0 ? 1 : words_.Capacity() * 2);
+        }
+        // Свободные биты последнего слова нулевые, поэтому новый бит достаточно добавить через ИЛИ
+        if (size_ % bit_vector_detail::WORD_BITS == 0) {
+            words_[WordIndex(size_)] = 0;
+        }
+        words_[WordIndex(size_)] |= static_cast<uint64_t>(value) << (size_ % bit_vector_detail::WORD_BITS);
+        ++size_;
+    }
+
+    void PopBack() noexcept {
+        assert(size_ > 0);
+        (*this)[size_ - 1] = false;
+        --size_;
+    }
+
+    void Clear() noexcept {
+        size_ = 0;
+    }
+
+    // Заполняет все биты значением value
+    void Fill(bool value) noexcept {
+        std::fill(words_.GetAddress(), words_.GetAddress() + WordCount(size_), value ? ~uint64_t{ 0 } : uint64_t{ 0 });
+        ClearUnusedBits();
+    }
+
+    // Побитовые операции над векторами одинакового размера
+    BitVector& operator&=(const BitVector& rhs) noexcept {
+        return Combine<bit_vector_detail::BitOp::AND>(rhs);
+    }
+
+    BitVector& operator|=(const BitVector& rhs) noexcept {
+        return Combine<bit_vector_detail::BitOp::OR>(rhs);
+    }
+
+    BitVector& operator^=(const BitVector& rhs) noexcept {
+        return Combine<bit_vector_detail::BitOp::XOR>(rhs);
+    }
+
+    // Инвертирует все биты
+    void FlipAll() noexcept {
+        bit_vector_detail::Invert(words_.GetAddress(), WordCount(size_));
+        ClearUnusedBits();
+    }
+
+    BitVector operator~() const {
+        BitVector result(*this);
+        result.FlipAll();
+        return result;
+    }
+
+    // Количество установленных битов
+    size_t Count() const noexcept {
+        size_t count = 0;
+        const size_t words = WordCount(size_);
+        for (size_t i = 0; i < words; ++i) {
+            count += bit_vector_detail::PopCount(words_[i]);
+        }
+        return count;
+    }
+
+    // Индекс первого установленного бита, не меньшего pos, либо Size(), если такого нет
+    size_t FindNext(size_t pos) const noexcept {
+        if (pos >= size_) {
+            return size_;
+        }
+        const size_t words = WordCount(size_);
+        size_t word_index = WordIndex(pos);
+        uint64_t word = words_[word_index] & (~uint64_t{ 0 } << (pos % bit_vector_detail::WORD_BITS));
+        if (word == 0) {
+            word_index = bit_vector_detail::FindNonZeroWord(words_.GetAddress(), word_index + 1, words);
+            if (word_index == words) {
+                return size_;
+            }
+            word = words_[word_index];
+        }
+        return word_index * bit_vector_detail::WORD_BITS + bit_vector_detail::LowestBit(word);
+    }
+
+    size_t FindFirst() const noexcept {
+        return FindNext(0);
+    }
+
+    bool operator==(const BitVector& rhs) const noexcept {
+        return size_ == rhs.size_
+            && std::equal(words_.GetAddress(), words_.GetAddress() + WordCount(size_), rhs.words_.GetAddress());
+    }
+
+    bool operator!=(const BitVector& rhs) const noexcept {
+        return !(*this == rhs);
+    }
+
+private:
+    static size_t WordCount(size_t bits) noexcept {
+        return bit_vector_detail::WordCount(bits);
+    }
+
+    static size_t WordIndex(size_t index) noexcept {
+        return index / bit_vector_detail::WORD_BITS;
+    }
+
+    static uint64_t BitMask(size_t index) noexcept {
+        return uint64_t{ 1 } << (index % bit_vector_detail::WORD_BITS);
+    }
+
+    // Обнуляет биты последнего слова, лежащие за пределами Size()
+    void ClearUnusedBits() noexcept {
+        const size_t tail = size_ % bit_vector_detail::WORD_BITS;
+        if (tail != 0) {
+            words_[WordIndex(size_)] &= ~(~uint64_t{ 0 } << tail);
+        }
+    }
+
+    // Слова копируются побайтно: исключение возможно только при выделении памяти
+    void Reallocate(size_t new_word_capacity) {
+        RawMemory<uint64_t> new_words(new_word_capacity);
+        if (size_ > 0) {
+            std::memcpy(new_words.GetAddress(), words_.GetAddress(), WordCount(size_) * sizeof(uint64_t));
+        }
+        words_.Swap(new_words);
+    }
+
+    template <bit_vector_detail::BitOp OP>
+    BitVector& Combine(const BitVector& rhs) noexcept {
+        assert(size_ == rhs.size_);
+        bit_vector_detail::Combine<OP>(words_.GetAddress(), rhs.words_.GetAddress(), WordCount(size_));
+        return *this;
+    }
+
+    RawMemory<uint64_t> words_;
+    size_t size_ = 0;
+};
+
+inline BitVector operator&(BitVector lhs, const BitVector& rhs) noexcept {
+    lhs &= rhs;
+    return lhs;
+}
+
+inline BitVector operator|(BitVector lhs, const BitVector& rhs) noexcept {
+    lhs |= rhs;
+    return lhs;
+}
+
+inline BitVector operator^(BitVector lhs, const BitVector& rhs) noexcept {
+    lhs ^= rhs;
+    return lhs;
+}
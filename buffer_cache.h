@@ -0,0 +1,267 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+
+#if defined(__SANITIZE_ADDRESS__)
+#define BUFFER_CACHE_ASAN
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define BUFFER_CACHE_ASAN
+#endif
+#endif
+
+#ifdef BUFFER_CACHE_ASAN
+#include <sanitizer/asan_interface.h>
+#endif
+
+// Кеш освобождённых буферов, разбитых на классы размеров по степеням двойки.
+// У каждого потока свой кеш без блокировок. Буферы, не поместившиеся в лимит потока,
+// а также буферы завершившегося потока попадают в общий склад под мьютексом,
+// откуда их может забрать любой поток.
+// Буфер, освобождённый в чужом потоке, остаётся в кеше этого потока, пока тот не завершится,
+// не превысит свой лимит или не вызовет Flush(). Потоку, который в основном освобождает
+// чужие буферы, стоит периодически вызывать Flush(), иначе владелец их не увидит.
+// Выигрыш заметен на буферах от сотен килобайт, которые malloc отдаёт через mmap и munmap:
+// многократный рост таких векторов ускоряется в несколько раз. Небольшие буферы malloc
+// и так переиспользует быстро, на них кеш не ускоряет работу.
+// RawMemory пользуется кешем, если определён макрос VECTOR_BUFFER_CACHE
+class BufferCache {
+public:
+    struct Stats {
+        size_t hits = 0;            // выдано из кеша потока
+        size_t shared_hits = 0;     // выдано из общего склада
+        size_t misses = 0;          // выделено через operator new
+        size_t cached_frees = 0;    // возвращено в кеш потока
+        size_t shared_frees = 0;    // передано в общий склад
+        size_t released_frees = 0;  // возвращено через operator delete
+
+        double HitRate() const noexcept {
+            const size_t total = hits + shared_hits + misses;
+            return total == 0 ? 0.0 : static_cast<double>(hits + shared_hits) / static_cast<double>(total);
+        }
+    };
+
+    static constexpr size_t DEFAULT_BYTE_LIMIT = size_t{ 1 } << 20;
+    static constexpr size_t DEFAULT_SHARED_BYTE_LIMIT = size_t{ 8 } << 20;
+
+    BufferCache() = default;
+    BufferCache(const BufferCache&) = delete;
+    BufferCache& operator=(const BufferCache&) = delete;
+
+    ~BufferCache() {
+        // Буферы завершающегося потока отдаются другим потокам
+        Flush();
+        LocalDestroyed() = true;
+    }
+
+    // Кеш текущего потока
+    static BufferCache& Local() noexcept {
+        thread_local BufferCache cache;
+        return cache;
+    }
+
+    // Выделяет буфер не меньше bytes байт через кеш текущего потока
+    static void* AllocateBuffer(size_t bytes) {
+        return LocalDestroyed() ? ::operator new(ClassSize(bytes)) : Local().Allocate(bytes);
+    }
+
+    // Возвращает буфер, выделенный AllocateBuffer с тем же bytes, в любом потоке
+    static void DeallocateBuffer(void* ptr, size_t bytes) noexcept {
+#ifdef BUFFER_CACHE_ASAN
+        // Владелец мог пометить часть буфера недоступной для ASan, а кеш пишет в его начало
+        // и отдаёт блок класса целиком следующему владельцу
+        if (ptr != nullptr) {
+            __asan_unpoison_memory_region(ptr, ClassSize(bytes));
+        }
+#endif
+        if (LocalDestroyed()) {
+            ::operator delete(ptr);
+        }
+        else {
+            Local().Deallocate(ptr, bytes);
+        }
+    }
+
+    // Размер блока, который фактически выделяется под bytes байт
+    static size_t ClassSize(size_t bytes) noexcept {
+        return size_t{ 1 } << ClassOf(bytes);
+    }
+
+    void* Allocate(size_t bytes) {
+        const size_t size_class = ClassOf(bytes);
+        if (FreeNode* node = lists_[size_class]) {
+            lists_[size_class] = node->next;
+            cached_bytes_ -= size_t{ 1 } << size_class;
+            ++stats_.hits;
+            return node;
+        }
+        if (void* ptr = AcquireFromShared(size_class)) {
+            ++stats_.shared_hits;
+            return ptr;
+        }
+        ++stats_.misses;
+        return ::operator new(size_t{ 1 } << size_class);
+    }
+
+    void Deallocate(void* ptr, size_t bytes) noexcept {
+        if (ptr == nullptr) {
+            return;
+        }
+        const size_t size_class = ClassOf(bytes);
+        const size_t class_size = size_t{ 1 } << size_class;
+        if (cached_bytes_ + class_size <= byte_limit_) {
+            lists_[size_class] = new (ptr) FreeNode{ lists_[size_class] };
+            cached_bytes_ += class_size;
+            ++stats_.cached_frees;
+        }
+        else if (ReleaseToShared(ptr, size_class)) {
+            ++stats_.shared_frees;
+        }
+        else {
+            ++stats_.released_frees;
+        }
+    }
+
+    // Ограничивает объём буферов в кеше потока; лишние буферы уходят в общий склад
+    void SetByteLimit(size_t byte_limit) noexcept {
+        byte_limit_ = byte_limit;
+        for (size_t size_class = NUM_CLASSES; size_class-- > 0 && cached_bytes_ > byte_limit_;) {
+            while (FreeNode* node = lists_[size_class]) {
+                if (cached_bytes_ <= byte_limit_) {
+                    break;
+                }
+                lists_[size_class] = node->next;
+                cached_bytes_ -= size_t{ 1 } << size_class;
+                ReleaseToShared(node, size_class);
+            }
+        }
+    }
+
+    // Передаёт все буферы кеша потока в общий склад
+    void Flush() noexcept {
+        for (size_t size_class = 0; size_class < NUM_CLASSES; ++size_class) {
+            while (FreeNode* node = lists_[size_class]) {
+                lists_[size_class] = node->next;
+                ReleaseToShared(node, size_class);
+            }
+        }
+        cached_bytes_ = 0;
+    }
+
+    size_t ByteLimit() const noexcept {
+        return byte_limit_;
+    }
+
+    size_t CachedBytes() const noexcept {
+        return cached_bytes_;
+    }
+
+    const Stats& GetStats() const noexcept {
+        return stats_;
+    }
+
+    void ResetStats() noexcept {
+        stats_ = Stats{};
+    }
+
+    // Ограничивает объём общего склада; при уменьшении лишние буферы освобождаются
+    static void SetSharedByteLimit(size_t byte_limit) noexcept {
+        SharedDepot& depot = Shared();
+        std::lock_guard guard(depot.mutex);
+        depot.byte_limit = byte_limit;
+        for (size_t size_class = NUM_CLASSES; size_class-- > 0 && depot.cached_bytes > byte_limit;) {
+            while (FreeNode* node = depot.lists[size_class]) {
+                if (depot.cached_bytes <= byte_limit) {
+                    break;
+                }
+                depot.lists[size_class] = node->next;
+                depot.cached_bytes -= size_t{ 1 } << size_class;
+                ::operator delete(node);
+            }
+        }
+    }
+
+    static size_t SharedCachedBytes() noexcept {
+        SharedDepot& depot = Shared();
+        std::lock_guard guard(depot.mutex);
+        return depot.cached_bytes;
+    }
+
+private:
+    static constexpr size_t NUM_CLASSES = sizeof(size_t) * 8;
+    // Наименьший класс вмещает узел списка свободных блоков
+    static constexpr size_t MIN_CLASS = 4;
+
+    struct FreeNode {
+        FreeNode* next;
+    };
+
+    struct SharedDepot {
+        ~SharedDepot() {
+            for (FreeNode* list : lists) {
+                while (FreeNode* node = list) {
+                    list = node->next;
+                    ::operator delete(node);
+                }
+            }
+        }
+
+        std::mutex mutex;
+        FreeNode* lists[NUM_CLASSES] = {};
+        size_t cached_bytes = 0;
+        size_t byte_limit = DEFAULT_SHARED_BYTE_LIMIT;
+    };
+
+    static size_t ClassOf(size_t bytes) noexcept {
+        size_t size_class = MIN_CLASS;
+        while (size_class + 1 < NUM_CLASSES && (size_t{ 1 } << size_class) < bytes) {
+            ++size_class;
+        }
+        return size_class;
+    }
+
+    // Флаг тривиального типа остаётся доступным и после разрушения кеша потока
+    static bool& LocalDestroyed() noexcept {
+        thread_local bool destroyed = false;
+        return destroyed;
+    }
+
+    static SharedDepot& Shared() noexcept {
+        static SharedDepot depot;
+        return depot;
+    }
+
+    static void* AcquireFromShared(size_t size_class) noexcept {
+        SharedDepot& depot = Shared();
+        std::lock_guard guard(depot.mutex);
+        FreeNode* node = depot.lists[size_class];
+        if (node != nullptr) {
+            depot.lists[size_class] = node->next;
+            depot.cached_bytes -= size_t{ 1 } << size_class;
+        }
+        return node;
+    }
+
+    // Возвращает false, если склад заполнен и буфер пришлось освободить
+    static bool ReleaseToShared(void* ptr, size_t size_class) noexcept {
+        SharedDepot& depot = Shared();
+        const size_t class_size = size_t{ 1 } << size_class;
+        {
+            std::lock_guard guard(depot.mutex);
+            if (depot.cached_bytes + class_size <= depot.byte_limit) {
+                depot.lists[size_class] = new (ptr) FreeNode{ depot.lists[size_class] };
+                depot.cached_bytes += class_size;
+                return true;
+            }
+        }
+        ::operator delete(ptr);
+        return false;
+    }
+
+    FreeNode* lists_[NUM_CLASSES] = {};
+    size_t cached_bytes_ = 0;
+    size_t byte_limit_ = DEFAULT_BYTE_LIMIT;
+    Stats stats_;
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+#if __cplusplus >= 202002L && __has_include(<source_location>)
+#include <source_location>
+#endif
+
+// Место вызова в исходном коде. По умолчанию Current() возвращает место,
+// откуда был вызван метод, принимающий CallSite параметром по умолчанию.
+// Место можно задать и явно, например CallSite{ "batch" }: тогда оно служит меткой
+struct CallSite {
+#if __cplusplus >= 202002L && __has_include(<source_location>)
+    static constexpr CallSite Current(std::source_location location = std::source_location::current()) noexcept {
+        return { location.file_name(), location.function_name(), static_cast<unsigned>(location.line()) };
+    }
+#else
+    static constexpr CallSite Current(const char* file = __builtin_FILE(), const char* function = __builtin_FUNCTION(),
+        unsigned line = __builtin_LINE()) noexcept {
+        return { file, function, line };
+    }
+#endif
+
+    const char* file = "";
+    const char* function = "";
+    unsigned line = 0;
+};
@@ -0,0 +1,127 @@
+#pragma once
+#include "call_site.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+// Подсказывает начальную вместимость Vector по итоговым размерам векторов, созданных
+// в том же месте. Для каждого места хранятся последние WINDOW размеров, а подсказкой
+// служит их 90-й перцентиль. Таблица своя у каждого потока, имеет фиксированный размер
+// и не обращается к куче, поэтому подсказки детерминированы и не требуют блокировок.
+// Vector пользуется подсказками, если определён макрос VECTOR_ADAPTIVE_CAPACITY
+class CapacityAdvisor {
+public:
+    static constexpr size_t WINDOW = 16;
+    // Меньше этого числа размеров подсказка не выдаётся
+    static constexpr size_t MIN_SAMPLES = 4;
+    static constexpr size_t TABLE_SIZE = 256;
+    static constexpr size_t DEFAULT_MAX_HINT_BYTES = size_t{ 64 } << 10;
+
+    // Подсказчик текущего потока
+    static CapacityAdvisor& Local() noexcept {
+        thread_local CapacityAdvisor advisor;
+        return advisor;
+    }
+
+    // Рекомендуемая вместимость в элементах размера element_size либо 0, если данных мало.
+    // Подсказка не превышает MaxHintBytes() байт
+    size_t Suggest(const CallSite& site, size_t element_size) const noexcept {
+        const Entry* entry = Find(site);
+        if (entry == nullptr || entry->count < MIN_SAMPLES) {
+            return 0;
+        }
+        return std::min<size_t>(entry->estimate, max_hint_bytes_ / std::max<size_t>(element_size, 1));
+    }
+
+    void RecordFinalSize(const CallSite& site, size_t size) noexcept {
+        Entry* entry = FindOrInsert(site);
+        if (entry == nullptr) {
+            return;
+        }
+        entry->samples[entry->next] = static_cast<uint32_t>(std::min<size_t>(size, UINT32_MAX));
+        entry->next = (entry->next + 1) % WINDOW;
+        entry->count = std::min(entry->count + 1, WINDOW);
+        entry->estimate = Percentile90(*entry);
+    }
+
+    // Ограничивает размер подсказки в байтах; 0 отключает подсказки
+    void SetMaxHintBytes(size_t max_hint_bytes) noexcept {
+        max_hint_bytes_ = max_hint_bytes;
+    }
+
+    size_t MaxHintBytes() const noexcept {
+        return max_hint_bytes_;
+    }
+
+    // Забывает все накопленные размеры
+    void Clear() noexcept {
+        for (Entry& entry : entries_) {
+            entry = Entry{};
+        }
+    }
+
+private:
+    struct Entry {
+        const char* file = nullptr;
+        unsigned line = 0;
+        uint32_t samples[WINDOW] = {};
+        size_t next = 0;
+        size_t count = 0;
+        size_t estimate = 0;
+    };
+
+    // Место определяется адресом имени файла и строкой, как в ReallocationProfiler: сравнение
+    // не зависит от длины имени. Метки с одинаковым текстом по разным адресам (например,
+    // из разных единиц трансляции) считаются разными местами
+    static size_t Hash(const CallSite& site) noexcept {
+        return std::hash<const void*>{}(site.file) ^ (static_cast<size_t>(site.line) * 0x9E3779B97F4A7C15ull);
+    }
+
+    static bool IsSameSite(const Entry& entry, const CallSite& site) noexcept {
+        return entry.file == site.file && entry.line == site.line;
+    }
+
+    const Entry* Find(const CallSite& site) const noexcept {
+        const size_t hash = Hash(site);
+        for (size_t probe = 0; probe < TABLE_SIZE; ++probe) {
+            const Entry& entry = entries_[(hash + probe) % TABLE_SIZE];
+            if (entry.file == nullptr) {
+                return nullptr;
+            }
+            if (IsSameSite(entry, site)) {
+                return &entry;
+            }
+        }
+        return nullptr;
+    }
+
+    // Возвращает nullptr, если таблица заполнена: такие места остаются без подсказок
+    Entry* FindOrInsert(const CallSite& site) noexcept {
+        const size_t hash = Hash(site);
+        for (size_t probe = 0; probe < TABLE_SIZE; ++probe) {
+            Entry& entry = entries_[(hash + probe) % TABLE_SIZE];
+            if (entry.file == nullptr) {
+                entry.file = site.file;
+                entry.line = site.line;
+                return &entry;
+            }
+            if (IsSameSite(entry, site)) {
+                return &entry;
+            }
+        }
+        return nullptr;
+    }
+
+    static size_t Percentile90(const Entry& entry) noexcept {
+        uint32_t sorted[WINDOW];
+        std::copy_n(entry.samples, entry.count, sorted);
+        const size_t rank = (entry.count * 9 + 9) / 10 - 1;
+        std::nth_element(sorted, sorted + rank, sorted + entry.count);
+        return sorted[rank];
+    }
+
+    Entry entries_[TABLE_SIZE];
+    size_t max_hint_bytes_ = DEFAULT_MAX_HINT_BYTES;
+};
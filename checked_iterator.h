@@ -0,0 +1,194 @@
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <cstdlib>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+namespace checked_iterator_detail {
+
+    // Счётчики поколений выделяются через malloc: отладочные итераторы не меняют число
+    // обращений к operator new, которое проверяют контракты стоимости операций Vector
+    template <typename T>
+    struct MallocAllocator {
+        using value_type = T;
+
+        MallocAllocator() = default;
+
+        template <typename U>
+        MallocAllocator(const MallocAllocator<U>&) noexcept {
+        }
+
+        T* allocate(size_t n) {
+            if (void* ptr = std::malloc(n * sizeof(T))) {
+                return static_cast<T*>(ptr);
+            }
+            throw std::bad_alloc();
+        }
+
+        void deallocate(T* ptr, size_t) noexcept {
+            std::free(ptr);
+        }
+
+        template <typename U>
+        bool operator==(const MallocAllocator<U>&) const noexcept {
+            return true;
+        }
+
+        template <typename U>
+        bool operator!=(const MallocAllocator<U>&) const noexcept {
+            return false;
+        }
+    };
+
+}  // namespace checked_iterator_detail
+
+// Номер поколения буфера. Им совместно владеют вектор и его итераторы, поэтому итератор
+// может проверить себя и после того, как вектор перемещён или разрушен
+using IteratorGeneration = std::shared_ptr<size_t>;
+
+inline IteratorGeneration MakeIteratorGeneration() {
+    return std::allocate_shared<size_t>(checked_iterator_detail::MallocAllocator<size_t>(), 0);
+}
+
+// Итератор отладочной сборки Vector. Запоминает номер поколения буфера вектора на момент
+// создания и проверяет через assert, что буфер с тех пор не перевыделялся и не освобождался:
+// разыменование итератора, полученного до Reserve, вставки с реаллокацией или разрушения
+// вектора, останавливает программу. Vector использует его вместо T*, если определён макрос
+// VECTOR_CHECKED_ITERATORS. К указателю приводится только явно, без проверки;
+// простой указатель на элементы даёт Vector::Data()
+template <typename T>
+class CheckedIterator {
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = std::remove_cv_t<T>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using reference = T&;
+
+    CheckedIterator() = default;
+
+    CheckedIterator(T* ptr, std::shared_ptr<const size_t> generation) noexcept
+        : ptr_(ptr)
+        , generation_(std::move(generation))
+        , expected_generation_(generation_ == nullptr ? 0 : *generation_) {
+    }
+
+    // iterator приводится к const_iterator
+    template <typename U, typename = std::enable_if_t<std::is_same_v<const U, T> && !std::is_same_v<U, T>>>
+    CheckedIterator(const CheckedIterator<U>& other) noexcept
+        : ptr_(other.ptr_)
+        , generation_(other.generation_)
+        , expected_generation_(other.expected_generation_) {
+    }
+
+    explicit operator T*() const noexcept {
+        return ptr_;
+    }
+
+    T& operator*() const noexcept {
+        AssertValid();
+        return *ptr_;
+    }
+
+    T* operator->() const noexcept {
+        AssertValid();
+        return ptr_;
+    }
+
+    T& operator[](difference_type offset) const noexcept {
+        AssertValid();
+        return ptr_[offset];
+    }
+
+    CheckedIterator& operator++() noexcept {
+        ++ptr_;
+        return *this;
+    }
+
+    CheckedIterator operator++(int) noexcept {
+        CheckedIterator old = *this;
+        ++ptr_;
+        return old;
+    }
+
+    CheckedIterator& operator--() noexcept {
+        --ptr_;
+        return *this;
+    }
+
+    CheckedIterator operator--(int) noexcept {
+        CheckedIterator old = *this;
+        --ptr_;
+        return old;
+    }
+
+    CheckedIterator& operator+=(difference_type offset) noexcept {
+        ptr_ += offset;
+        return *this;
+    }
+
+    CheckedIterator& operator-=(difference_type offset) noexcept {
+        ptr_ -= offset;
+        return *this;
+    }
+
+    CheckedIterator operator+(difference_type offset) const noexcept {
+        return CheckedIterator(*this) += offset;
+    }
+
+    CheckedIterator operator-(difference_type offset) const noexcept {
+        return CheckedIterator(*this) -= offset;
+    }
+
+    friend CheckedIterator operator+(difference_type offset, const CheckedIterator& it) noexcept {
+        return it + offset;
+    }
+
+    friend difference_type operator-(const CheckedIterator& lhs, const CheckedIterator& rhs) noexcept {
+        return lhs.ptr_ - rhs.ptr_;
+    }
+
+    friend bool operator==(const CheckedIterator& lhs, const CheckedIterator& rhs) noexcept {
+        return lhs.ptr_ == rhs.ptr_;
+    }
+
+    friend bool operator!=(const CheckedIterator& lhs, const CheckedIterator& rhs) noexcept {
+        return lhs.ptr_ != rhs.ptr_;
+    }
+
+    friend bool operator<(const CheckedIterator& lhs, const CheckedIterator& rhs) noexcept {
+        return lhs.ptr_ < rhs.ptr_;
+    }
+
+    friend bool operator>(const CheckedIterator& lhs, const CheckedIterator& rhs) noexcept {
+        return lhs.ptr_ > rhs.ptr_;
+    }
+
+    friend bool operator<=(const CheckedIterator& lhs, const CheckedIterator& rhs) noexcept {
+        return lhs.ptr_ <= rhs.ptr_;
+    }
+
+    friend bool operator>=(const CheckedIterator& lhs, const CheckedIterator& rhs) noexcept {
+        return lhs.ptr_ >= rhs.ptr_;
+    }
+
+    // Истинно, если буфер, в который указывает итератор, не перевыделялся
+    bool IsValid() const noexcept {
+        return generation_ == nullptr || *generation_ == expected_generation_;
+    }
+
+private:
+    template <typename U>
+    friend class CheckedIterator;
+
+    void AssertValid() const noexcept {
+        assert(IsValid() && "iterator invalidated by Vector reallocation");
+    }
+
+    T* ptr_ = nullptr;
+    std::shared_ptr<const size_t> generation_;
+    size_t expected_generation_ = 0;
+};
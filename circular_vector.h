@@ -0,0 +1,241 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <utility>
+
+// Кольцевой буфер с вставкой и удалением с обоих концов за O(1).
+// Вместимость всегда степень двойки, поэтому индекс в кольце вычисляется маской
+template <typename T>
+class CircularVector {
+public:
+    CircularVector() = default;
+
+    CircularVector(const CircularVector& other)
+        : data_(other.size_ == 0 ? 0 : RoundUpToPowerOfTwo(other.size_)) {
+        // Копия сразу разворачивается в начало буфера
+        const size_t first_part = std::min(other.size_, other.Capacity() - other.head_);
+        std::uninitialized_copy_n(other.data_ + other.head_, first_part, data_.GetAddress());
+        try {
+            std::uninitialized_copy_n(other.data_.GetAddress(), other.size_ - first_part, data_ + first_part);
+        }
+        catch (...) {
+            std::destroy_n(data_.GetAddress(), first_part);
+            throw;
+        }
+        size_ = other.size_;
+    }
+
+    CircularVector(CircularVector&& other) noexcept
+        : data_(std::move(other.data_))
+        , head_(std::exchange(other.head_, 0))
+        , size_(std::exchange(other.size_, 0)) {
+    }
+
+    CircularVector& operator=(const CircularVector& rhs) {
+        if (this != &rhs) {
+            CircularVector rhs_copy(rhs);
+            Swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    CircularVector& operator=(CircularVector&& rhs) noexcept {
+        if (this != &rhs) {
+            CircularVector rhs_moved(std::move(rhs));
+            Swap(rhs_moved);
+        }
+        return *this;
+    }
+
+    ~CircularVector() {
+        Clear();
+    }
+
+    void Swap(CircularVector& other) noexcept {
+        data_.Swap(other.data_);
+        std::swap(head_, other.head_);
+        std::swap(size_, other.size_);
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    size_t Capacity() const noexcept {
+        return data_.Capacity();
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<CircularVector&>(*this)[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return data_[Wrap(head_ + index)];
+    }
+
+    T& Front() noexcept {
+        return (*this)[0];
+    }
+
+    const T& Front() const noexcept {
+        return (*this)[0];
+    }
+
+    T& Back() noexcept {
+        return (*this)[size_ - 1];
+    }
+
+    const T& Back() const noexcept {
+        return (*this)[size_ - 1];
+    }
+
+    // Вместимость округляется вверх до степени двойки
+    void Reserve(size_t new_capacity) {
+        if (new_capacity <= data_.Capacity()) {
+            return;
+        }
+        RawMemory<T> new_data(RoundUpToPowerOfTwo(new_capacity));
+        RelocateTo(new_data);
+    }
+
+    void Clear() noexcept {
+        while (size_ > 0) {
+            PopBack();
+        }
+        head_ = 0;
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        if (size_ == Capacity()) {
+            // Новый элемент создаётся до переноса старых, так как аргументы могут ссылаться на них
+            RawMemory<T> new_data(GrownCapacity());
+            new (new_data + size_) T(std::forward<Args>(args)...);
+            try {
+                RelocateTo(new_data);
+            }
+            catch (...) {
+                std::destroy_at(new_data + size_);
+                throw;
+            }
+        }
+        else {
+            new (data_ + Wrap(head_ + size_)) T(std::forward<Args>(args)...);
+        }
+        ++size_;
+        return Back();
+    }
+
+    template <typename... Args>
+    T& EmplaceFront(Args&&... args) {
+        if (size_ == Capacity()) {
+            // После переноса голова окажется в начале нового буфера, а новый элемент займёт его последнюю ячейку
+            RawMemory<T> new_data(GrownCapacity());
+            const size_t front = new_data.Capacity() - 1;
+            new (new_data + front) T(std::forward<Args>(args)...);
+            try {
+                RelocateTo(new_data);
+            }
+            catch (...) {
+                std::destroy_at(new_data + front);
+                throw;
+            }
+            head_ = front;
+        }
+        else {
+            const size_t front = Wrap(head_ + Capacity() - 1);
+            new (data_ + front) T(std::forward<Args>(args)...);
+            head_ = front;
+        }
+        ++size_;
+        return Front();
+    }
+
+    template <typename S>
+    void PushBack(S&& value) {
+        EmplaceBack(std::forward<S>(value));
+    }
+
+    template <typename S>
+    void PushFront(S&& value) {
+        EmplaceFront(std::forward<S>(value));
+    }
+
+    void PopBack() noexcept {
+        assert(size_ > 0);
+        std::destroy_at(&Back());
+        --size_;
+    }
+
+    void PopFront() noexcept {
+        assert(size_ > 0);
+        std::destroy_at(&Front());
+        head_ = Wrap(head_ + 1);
+        --size_;
+    }
+
+private:
+    static size_t RoundUpToPowerOfTwo(size_t value) noexcept {
+        size_t result = 1;
+        while (result < value) {
+            result *= 2;
+        }
+        return result;
+    }
+
+    size_t Wrap(size_t index) const noexcept {
+        return index & (Capacity() - 1);
+    }
+
+    size_t GrownCapacity() const noexcept {
+        return size_ == 0 ? 1 : size_ * 2;
+    }
+
+    // Переносит элементы в начало new_data не более чем двумя непрерывными участками:
+    // от головы до конца буфера и от начала буфера до хвоста. Если перенос бросает
+    // исключение, уже созданные в new_data элементы разрушаются
+    void RelocateTo(RawMemory<T>& new_data) {
+        const size_t first_part = std::min(size_, Capacity() - head_);
+        const size_t second_part = size_ - first_part;
+        T* first = data_.GetAddress() + head_;
+        T* second = data_.GetAddress();
+        T* to = new_data.GetAddress();
+        size_t relocated = 0;
+        try {
+            RelocateN(first, first_part, to);
+            relocated = first_part;
+            RelocateN(second, second_part, to + first_part);
+        }
+        catch (...) {
+            std::destroy_n(to, relocated);
+            throw;
+        }
+        std::destroy_n(first, first_part);
+        std::destroy_n(second, second_part);
+        data_.Swap(new_data);
+        head_ = 0;
+    }
+
+    // Создаёт в неинициализированной памяти to копии count элементов from: перемещением,
+    // если оно не бросает исключений или T некопируем, и копированием в остальных случаях
+    static void RelocateN(T* from, size_t count, T* to) {
+        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+            std::uninitialized_move_n(from, count, to);
+        }
+        else {
+            std::uninitialized_copy_n(from, count, to);
+        }
+    }
+
+    RawMemory<T> data_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+};
@@ -0,0 +1,374 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FLAT_HASH_MAP_SSE2 1
+#endif
+
+namespace flat_hash_detail {
+
+    // Управляющий байт ячейки: EMPTY для свободной, либо младшие 7 бит хеша (H2) для занятой
+    constexpr int8_t EMPTY = -128;
+    constexpr size_t GROUP_WIDTH = 16;
+
+    // Группа из GROUP_WIDTH подряд идущих управляющих байтов, сравниваемая за одну операцию
+    class Group {
+    public:
+        explicit Group(const int8_t* ctrl) noexcept {
+#ifdef FLAT_HASH_MAP_SSE2
+            ctrl_ = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+#else
+            std::memcpy(ctrl_, ctrl, GROUP_WIDTH);
+#endif
+        }
+
+        // Битовая маска позиций, управляющий байт которых равен h2
+        uint32_t Match(int8_t h2) const noexcept {
+#ifdef FLAT_HASH_MAP_SSE2
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl_)));
+#else
+            uint32_t mask = 0;
+            for (size_t i = 0; i < GROUP_WIDTH; ++i) {
+                mask |= static_cast<uint32_t>(ctrl_[i] == h2) << i;
+            }
+            return mask;
+#endif
+        }
+
+        uint32_t MatchEmpty() const noexcept {
+            return Match(EMPTY);
+        }
+
+    private:
+#ifdef FLAT_HASH_MAP_SSE2
+        __m128i ctrl_;
+#else
+        int8_t ctrl_[GROUP_WIDTH];
+#endif
+    };
+
+    inline size_t LowestBit(uint32_t mask) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<size_t>(__builtin_ctz(mask));
+#else
+        size_t index = 0;
+        while ((mask & 1) == 0) {
+            mask >>= 1;
+            ++index;
+        }
+        return index;
+#endif
+    }
+
+    // Старшие 64 бита 128-битного произведения a * b
+    inline uint64_t MultiplyHigh(uint64_t a, uint64_t b) noexcept {
+#if defined(__SIZEOF_INT128__)
+        // __extension__ избавляет от предупреждения -Wpedantic о нестандартном типе
+        __extension__ typedef unsigned __int128 Uint128;
+        return static_cast<uint64_t>((static_cast<Uint128>(a) * b) >> 64);
+#else
+        const uint64_t a_low = a & 0xFFFFFFFF;
+        const uint64_t a_high = a >> 32;
+        const uint64_t b_low = b & 0xFFFFFFFF;
+        const uint64_t b_high = b >> 32;
+        const uint64_t low_low = a_low * b_low;
+        const uint64_t high_low = a_high * b_low;
+        const uint64_t cross = (low_low >> 32) + (high_low & 0xFFFFFFFF) + a_low * b_high;
+        return a_high * b_high + (high_low >> 32) + (cross >> 32);
+#endif
+    }
+
+    // Перемешивает биты хеша, чтобы и H1, и H2 зависели от всех его бит. Младшие биты
+    // произведения зависят только от младших бит ключа, поэтому к ним подмешивается
+    // старшая половина 128-битного произведения: иначе ключи, различающиеся лишь старшими
+    // битами (например, i << 40), попадали бы в одну цепочку с одинаковым H2
+    inline uint64_t Mix(size_t hash) noexcept {
+        constexpr uint64_t MULTIPLIER = 0x9E3779B97F4A7C15ull;
+        const uint64_t value = static_cast<uint64_t>(hash);
+        return (value * MULTIPLIER) ^ MultiplyHigh(value, MULTIPLIER);
+    }
+
+}  // namespace flat_hash_detail
+
+// Хеш-таблица с открытой адресацией в стиле SwissTable.
+// Ячейки и управляющие байты лежат в двух массивах RawMemory, линейное пробирование
+// проверяет сразу группу из 16 управляющих байтов. Удаление сдвигает следующие элементы
+// цепочки назад, поэтому надгробий (tombstones) нет и поиск не деградирует после удалений
+template <typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class FlatHashMap {
+public:
+    using value_type = std::pair<Key, Value>;
+
+    FlatHashMap() = default;
+
+    FlatHashMap(const FlatHashMap& other)
+        : hash_(other.hash_)
+        , equal_(other.equal_) {
+        Reserve(other.size_);
+        other.ForEach([this](const Key& key, const Value& value) {
+            TryEmplace(key, value);
+        });
+    }
+
+    FlatHashMap(FlatHashMap&& other) noexcept
+        : ctrl_(std::move(other.ctrl_))
+        , slots_(std::move(other.slots_))
+        , size_(std::exchange(other.size_, 0))
+        , hash_(std::move(other.hash_))
+        , equal_(std::move(other.equal_)) {
+    }
+
+    FlatHashMap& operator=(const FlatHashMap& rhs) {
+        if (this != &rhs) {
+            FlatHashMap rhs_copy(rhs);
+            Swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    FlatHashMap& operator=(FlatHashMap&& rhs) noexcept {
+        if (this != &rhs) {
+            FlatHashMap rhs_moved(std::move(rhs));
+            Swap(rhs_moved);
+        }
+        return *this;
+    }
+
+    ~FlatHashMap() {
+        DestroySlots();
+    }
+
+    void Swap(FlatHashMap& other) noexcept {
+        ctrl_.Swap(other.ctrl_);
+        slots_.Swap(other.slots_);
+        std::swap(size_, other.size_);
+        std::swap(hash_, other.hash_);
+        std::swap(equal_, other.equal_);
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    // Число ячеек таблицы (степень двойки либо 0)
+    size_t Capacity() const noexcept {
+        return slots_.Capacity();
+    }
+
+    // Гарантирует, что count элементов поместятся без перехеширования
+    void Reserve(size_t count) {
+        size_t capacity = flat_hash_detail::GROUP_WIDTH;
+        while (MaxSize(capacity) < count) {
+            if (capacity > std::numeric_limits<size_t>::max() / 2 / sizeof(value_type)) {
+                throw std::length_error("FlatHashMap is too large");
+            }
+            capacity *= 2;
+        }
+        if (capacity > Capacity()) {
+            Rehash(capacity);
+        }
+    }
+
+    void Clear() noexcept {
+        DestroySlots();
+        std::fill_n(ctrl_.GetAddress(), ctrl_.Capacity(), flat_hash_detail::EMPTY);
+        size_ = 0;
+    }
+
+    // Возвращает указатель на значение либо nullptr, если ключа нет
+    Value* Find(const Key& key) {
+        const size_t index = FindIndex(key);
+        return index == NOT_FOUND ? nullptr : &slots_[index].second;
+    }
+
+    const Value* Find(const Key& key) const {
+        return const_cast<FlatHashMap&>(*this).Find(key);
+    }
+
+    bool Contains(const Key& key) const {
+        return FindIndex(key) != NOT_FOUND;
+    }
+
+    Value& operator[](const Key& key) {
+        return *TryEmplace(key).first;
+    }
+
+    // Вставляет значение, если ключа ещё нет. Возвращает указатель на значение с этим ключом
+    // и признак того, что вставка произошла
+    template <typename K, typename... Args>
+    std::pair<Value*, bool> TryEmplace(K&& key, Args&&... args) {
+        const uint64_t hash = HashOf(key);
+        const size_t found = FindIndex(key, hash);
+        if (found != NOT_FOUND) {
+            return { &slots_[found].second, false };
+        }
+        if (size_ + 1 > MaxSize(Capacity())) {
+            Reserve(size_ + 1);
+        }
+        const size_t index = FindEmptySlot(hash);
+        new (slots_ + index) value_type(std::piecewise_construct,
+            std::forward_as_tuple(std::forward<K>(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+        SetCtrl(index, H2(hash));
+        ++size_;
+        return { &slots_[index].second, true };
+    }
+
+    template <typename K, typename V>
+    bool Insert(K&& key, V&& value) {
+        return TryEmplace(std::forward<K>(key), std::forward<V>(value)).second;
+    }
+
+    bool Erase(const Key& key) {
+        size_t hole = FindIndex(key);
+        if (hole == NOT_FOUND) {
+            return false;
+        }
+        const size_t mask = Capacity() - 1;
+        std::destroy_at(slots_ + hole);
+        // Сдвигаем назад элементы цепочки, чья домашняя ячейка не лежит между дыркой и ими
+        for (size_t next = (hole + 1) & mask; ctrl_[next] != flat_hash_detail::EMPTY; next = (next + 1) & mask) {
+            const size_t home = HashOf(slots_[next].first) >> 7 & mask;
+            const bool home_in_range = hole <= next ? hole < home && home <= next : hole < home || home <= next;
+            if (!home_in_range) {
+                RelocateSlot(slots_ + next, slots_ + hole);
+                SetCtrl(hole, ctrl_[next]);
+                hole = next;
+            }
+        }
+        SetCtrl(hole, flat_hash_detail::EMPTY);
+        --size_;
+        return true;
+    }
+
+    // Вызывает func(key, value) для каждого элемента в порядке ячеек
+    template <typename Func>
+    void ForEach(Func func) const {
+        for (size_t i = 0; i < Capacity(); ++i) {
+            if (ctrl_[i] != flat_hash_detail::EMPTY) {
+                func(slots_[i].first, slots_[i].second);
+            }
+        }
+    }
+
+private:
+    static constexpr size_t NOT_FOUND = static_cast<size_t>(-1);
+
+    // Максимальное число элементов при заполненности 7/8
+    static size_t MaxSize(size_t capacity) noexcept {
+        return capacity - capacity / 8;
+    }
+
+    template <typename K>
+    uint64_t HashOf(const K& key) const {
+        return flat_hash_detail::Mix(hash_(key));
+    }
+
+    static int8_t H2(uint64_t hash) noexcept {
+        return static_cast<int8_t>(hash & 0x7F);
+    }
+
+    size_t FindIndex(const Key& key) const {
+        return size_ == 0 ? NOT_FOUND : FindIndex(key, HashOf(key));
+    }
+
+    template <typename K>
+    size_t FindIndex(const K& key, uint64_t hash) const {
+        if (Capacity() == 0) {
+            return NOT_FOUND;
+        }
+        const size_t mask = Capacity() - 1;
+        for (size_t pos = hash >> 7 & mask;; pos = (pos + flat_hash_detail::GROUP_WIDTH) & mask) {
+            const flat_hash_detail::Group group(ctrl_ + pos);
+            for (uint32_t match = group.Match(H2(hash)); match != 0; match &= match - 1) {
+                const size_t index = (pos + flat_hash_detail::LowestBit(match)) & mask;
+                if (equal_(slots_[index].first, key)) {
+                    return index;
+                }
+            }
+            // Цепочка линейного пробирования обрывается на первой свободной ячейке
+            if (group.MatchEmpty() != 0) {
+                return NOT_FOUND;
+            }
+        }
+    }
+
+    size_t FindEmptySlot(uint64_t hash) const noexcept {
+        const size_t mask = Capacity() - 1;
+        for (size_t pos = hash >> 7 & mask;; pos = (pos + flat_hash_detail::GROUP_WIDTH) & mask) {
+            const uint32_t empty = flat_hash_detail::Group(ctrl_ + pos).MatchEmpty();
+            if (empty != 0) {
+                return (pos + flat_hash_detail::LowestBit(empty)) & mask;
+            }
+        }
+    }
+
+    // Первые GROUP_WIDTH - 1 управляющих байтов продублированы за концом массива,
+    // чтобы группу можно было читать с любой позиции без проверки на перенос
+    void SetCtrl(size_t index, int8_t value) noexcept {
+        ctrl_[index] = value;
+        if (index < flat_hash_detail::GROUP_WIDTH - 1) {
+            ctrl_[Capacity() + index] = value;
+        }
+    }
+
+    // Переносит элемент в сырую ячейку; тривиально копируемые типы копируются побайтно
+    static void RelocateSlot(value_type* from, value_type* to) noexcept {
+        if constexpr (std::is_trivially_copyable_v<value_type>) {
+            std::memcpy(static_cast<void*>(to), from, sizeof(value_type));
+        }
+        else {
+            static_assert(std::is_nothrow_move_constructible_v<value_type>,
+                "FlatHashMap requires nothrow move constructible keys and values");
+            new (to) value_type(std::move(*from));
+            std::destroy_at(from);
+        }
+    }
+
+    void Rehash(size_t new_capacity) {
+        RawMemory<value_type> new_slots(new_capacity);
+        RawMemory<int8_t> new_ctrl(new_capacity + flat_hash_detail::GROUP_WIDTH - 1);
+        std::fill_n(new_ctrl.GetAddress(), new_ctrl.Capacity(), flat_hash_detail::EMPTY);
+
+        ctrl_.Swap(new_ctrl);
+        slots_.Swap(new_slots);
+        // Ключи в таблице уникальны, поэтому сравнивать их при переносе не нужно
+        for (size_t i = 0; i < new_slots.Capacity(); ++i) {
+            if (new_ctrl[i] != flat_hash_detail::EMPTY) {
+                const uint64_t hash = HashOf(new_slots[i].first);
+                const size_t index = FindEmptySlot(hash);
+                RelocateSlot(new_slots + i, slots_ + index);
+                SetCtrl(index, H2(hash));
+            }
+        }
+    }
+
+    void DestroySlots() noexcept {
+        if constexpr (!std::is_trivially_destructible_v<value_type>) {
+            for (size_t i = 0; i < Capacity(); ++i) {
+                if (ctrl_[i] != flat_hash_detail::EMPTY) {
+                    std::destroy_at(slots_ + i);
+                }
+            }
+        }
+    }
+
+    RawMemory<int8_t> ctrl_;
+    RawMemory<value_type> slots_;
+    size_t size_ = 0;
+    Hash hash_;
+    KeyEqual equal_;
+};
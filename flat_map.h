@@ -0,0 +1,345 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Двоичный поиск без ветвлений: на каждом шаге вместо условного перехода
+// выбирается одна из двух половин, что компилятор превращает в cmov
+template <typename Key, typename K, typename Compare>
+const Key* BranchlessLowerBound(const Key* first, size_t count, const K& key, Compare comp) {
+    if (count == 0) {
+        return first;
+    }
+    while (count > 1) {
+        const size_t half = count / 2;
+        first = comp(first[half], key) ? first + half : first;
+        count -= half;
+    }
+    return first + (comp(*first, key) ? 1 : 0);
+}
+
+// Отсортированное множество уникальных ключей в непрерывном массиве
+template <typename Key, typename Compare = std::less<Key>>
+class FlatSet {
+public:
+    using const_iterator = typename Vector<Key>::const_iterator;
+
+    FlatSet() = default;
+
+    explicit FlatSet(Compare comp)
+        : comp_(std::move(comp)) {
+    }
+
+    const_iterator begin() const noexcept {
+        return keys_.begin();
+    }
+    const_iterator end() const noexcept {
+        return keys_.end();
+    }
+
+    size_t Size() const noexcept {
+        return keys_.Size();
+    }
+
+    bool IsEmpty() const noexcept {
+        return keys_.Size() == 0;
+    }
+
+    void Reserve(size_t capacity) {
+        keys_.Reserve(capacity);
+    }
+
+    void Clear() noexcept {
+        keys_.Clear();
+    }
+
+    const_iterator LowerBound(const Key& key) const {
+        return LowerBoundImpl(key);
+    }
+
+    // Гетерогенный поиск доступен, если компаратор прозрачный (например, std::less<>)
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    const_iterator LowerBound(const K& key) const {
+        return LowerBoundImpl(key);
+    }
+
+    const_iterator Find(const Key& key) const {
+        return FindImpl(key);
+    }
+
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    const_iterator Find(const K& key) const {
+        return FindImpl(key);
+    }
+
+    bool Contains(const Key& key) const {
+        return Find(key) != end();
+    }
+
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    bool Contains(const K& key) const {
+        return Find(key) != end();
+    }
+
+    // Возвращает false, если такой ключ уже есть
+    template <typename K>
+    bool Insert(K&& key) {
+        const_iterator pos = LowerBound(key);
+        if (pos != end() && !comp_(key, *pos)) {
+            return false;
+        }
+        keys_.Emplace(pos, std::forward<K>(key));
+        return true;
+    }
+
+    // Вставляет диапазон ключей: сортирует его один раз и сливает с имеющимися за O(n + k)
+    template <typename InputIt>
+    void InsertRange(InputIt first, InputIt last) {
+        Vector<Key> batch;
+        for (; first != last; ++first) {
+            if (!Contains(*first)) {
+                batch.EmplaceBack(*first);
+            }
+        }
+        std::sort(batch.begin(), batch.end(), comp_);
+        auto unique_end = std::unique(batch.begin(), batch.end(), [this](const Key& lhs, const Key& rhs) {
+            return !comp_(lhs, rhs) && !comp_(rhs, lhs);
+        });
+        keys_.InsertSorted(std::make_move_iterator(batch.begin()), std::make_move_iterator(unique_end), comp_);
+    }
+
+    bool Erase(const Key& key) {
+        const_iterator pos = Find(key);
+        if (pos == end()) {
+            return false;
+        }
+        keys_.Erase(pos);
+        return true;
+    }
+
+private:
+    template <typename K>
+    const_iterator LowerBoundImpl(const K& key) const {
+        return keys_.begin() + (BranchlessLowerBound(keys_.Data(), keys_.Size(), key, comp_) - keys_.Data());
+    }
+
+    template <typename K>
+    const_iterator FindImpl(const K& key) const {
+        const_iterator pos = LowerBoundImpl(key);
+        return pos != end() && !comp_(key, *pos) ? pos : end();
+    }
+
+    Vector<Key> keys_;
+    Compare comp_{};
+};
+
+// Отсортированный ассоциативный массив. Ключи и значения хранятся в отдельных массивах,
+// поэтому двоичный поиск читает только плотно упакованные ключи
+template <typename Key, typename Value, typename Compare = std::less<Key>>
+class FlatMap {
+public:
+    FlatMap() = default;
+
+    explicit FlatMap(Compare comp)
+        : comp_(std::move(comp)) {
+    }
+
+    size_t Size() const noexcept {
+        return keys_.Size();
+    }
+
+    bool IsEmpty() const noexcept {
+        return keys_.Size() == 0;
+    }
+
+    void Reserve(size_t capacity) {
+        keys_.Reserve(capacity);
+        values_.Reserve(capacity);
+    }
+
+    void Clear() noexcept {
+        keys_.Clear();
+        values_.Clear();
+    }
+
+    const Vector<Key>& Keys() const noexcept {
+        return keys_;
+    }
+
+    const Vector<Value>& Values() const noexcept {
+        return values_;
+    }
+
+    Vector<Value>& Values() noexcept {
+        return values_;
+    }
+
+    // Возвращает указатель на значение либо nullptr, если ключа нет
+    Value* Find(const Key& key) {
+        return FindImpl(key);
+    }
+
+    const Value* Find(const Key& key) const {
+        return const_cast<FlatMap&>(*this).FindImpl(key);
+    }
+
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    Value* Find(const K& key) {
+        return FindImpl(key);
+    }
+
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    const Value* Find(const K& key) const {
+        return const_cast<FlatMap&>(*this).FindImpl(key);
+    }
+
+    bool Contains(const Key& key) const {
+        return Find(key) != nullptr;
+    }
+
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    bool Contains(const K& key) const {
+        return Find(key) != nullptr;
+    }
+
+    // Метод At() генерирует исключение std::out_of_range, если ключа нет
+    Value& At(const Key& key) {
+        if (Value* value = Find(key)) {
+            return *value;
+        }
+        throw std::out_of_range("FlatMap key not found");
+    }
+
+    const Value& At(const Key& key) const {
+        return const_cast<FlatMap&>(*this).At(key);
+    }
+
+    Value& operator[](const Key& key) {
+        return *TryEmplace(key).first;
+    }
+
+    // Вставляет значение, если ключа ещё нет. Возвращает указатель на значение с этим ключом
+    // и признак того, что вставка произошла
+    template <typename K, typename... Args>
+    std::pair<Value*, bool> TryEmplace(K&& key, Args&&... args) {
+        const size_t index = LowerBoundIndex(key);
+        if (index != keys_.Size() && !comp_(key, keys_[index])) {
+            return { &values_[index], false };
+        }
+        keys_.Emplace(keys_.begin() + index, std::forward<K>(key));
+        try {
+            values_.Emplace(values_.begin() + index, std::forward<Args>(args)...);
+        }
+        catch (...) {
+            keys_.Erase(keys_.begin() + index);
+            throw;
+        }
+        return { &values_[index], true };
+    }
+
+    template <typename K, typename V>
+    bool Insert(K&& key, V&& value) {
+        return TryEmplace(std::forward<K>(key), std::forward<V>(value)).second;
+    }
+
+    // Вставляет диапазон пар ключ-значение. Пакет сортируется один раз и сливается
+    // с имеющимися элементами за O(n + k) с одной аллокацией на каждый новый массив.
+    // Как и при одиночной вставке, уже существующие ключи не перезаписываются.
+    // Все сравнения выполняются до переноса элементов, а элементы словаря перемещаются,
+    // только если это не бросает исключений, поэтому при исключении словарь остаётся прежним
+    template <typename InputIt>
+    void InsertRange(InputIt first, InputIt last) {
+        Vector<std::pair<Key, Value>> batch;
+        for (; first != last; ++first) {
+            batch.EmplaceBack((*first).first, (*first).second);
+        }
+        if (batch.Size() == 0) {
+            return;
+        }
+        std::stable_sort(batch.begin(), batch.end(), [this](const auto& lhs, const auto& rhs) {
+            return comp_(lhs.first, rhs.first);
+        });
+
+        // Для каждого ключа пакета число предшествующих ему ключей словаря либо SKIP,
+        // если ключ уже есть в словаре или пакет содержит его повторно (берётся первый)
+        constexpr size_t SKIP = static_cast<size_t>(-1);
+        Vector<size_t> positions;
+        positions.Reserve(batch.Size());
+        size_t left = 0;
+        for (size_t right = 0; right < batch.Size(); ++right) {
+            const Key& key = batch[right].first;
+            while (left < keys_.Size() && comp_(keys_[left], key)) {
+                ++left;
+            }
+            const bool present = left < keys_.Size() && !comp_(key, keys_[left]);
+            const bool repeated = right > 0 && !comp_(batch[right - 1].first, key);
+            positions.PushBack(present || repeated ? SKIP : left);
+        }
+
+        Vector<Key> keys;
+        Vector<Value> values;
+        keys.Reserve(keys_.Size() + batch.Size());
+        values.Reserve(keys_.Size() + batch.Size());
+        left = 0;
+        for (size_t right = 0; right < batch.Size(); ++right) {
+            if (positions[right] == SKIP) {
+                continue;
+            }
+            for (; left < positions[right]; ++left) {
+                TakeOwn(left, keys, values);
+            }
+            keys.PushBack(std::move(batch[right].first));
+            values.PushBack(std::move(batch[right].second));
+        }
+        for (; left < keys_.Size(); ++left) {
+            TakeOwn(left, keys, values);
+        }
+        keys_ = std::move(keys);
+        values_ = std::move(values);
+    }
+
+    bool Erase(const Key& key) {
+        const size_t index = LowerBoundIndex(key);
+        if (index == keys_.Size() || comp_(key, keys_[index])) {
+            return false;
+        }
+        keys_.Erase(keys_.begin() + index);
+        values_.Erase(values_.begin() + index);
+        return true;
+    }
+
+private:
+    // Переносит элемент index в новые массивы: перемещением, если ни ключ, ни значение
+    // не бросают исключений при перемещении (или их нельзя скопировать), иначе копированием
+    void TakeOwn(size_t index, Vector<Key>& keys, Vector<Value>& values) {
+        constexpr bool move = (std::is_nothrow_move_constructible_v<Key> && std::is_nothrow_move_constructible_v<Value>)
+            || !(std::is_copy_constructible_v<Key> && std::is_copy_constructible_v<Value>);
+        if constexpr (move) {
+            keys.PushBack(std::move(keys_[index]));
+            values.PushBack(std::move(values_[index]));
+        }
+        else {
+            keys.PushBack(keys_[index]);
+            values.PushBack(values_[index]);
+        }
+    }
+
+    template <typename K>
+    size_t LowerBoundIndex(const K& key) const {
+        return BranchlessLowerBound(keys_.Data(), keys_.Size(), key, comp_) - keys_.Data();
+    }
+
+    template <typename K>
+    Value* FindImpl(const K& key) {
+        const size_t index = LowerBoundIndex(key);
+        return index != keys_.Size() && !comp_(key, keys_[index]) ? &values_[index] : nullptr;
+    }
+
+    Vector<Key> keys_;
+    Vector<Value> values_;
+    Compare comp_{};
+};
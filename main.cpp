@@ -1,8 +1,32 @@
+#include "bit_vector.h"
+#include "buffer_cache.h"
+#include "capacity_advisor.h"
+#include "checked_iterator.h"
+#include "circular_vector.h"
+#include "compressed_int_vector.h"
+#include "flat_hash_map.h"
+#include "flat_map.h"
+#include "optional.h"
+#include "parallel_vector_builder.h"
+#include "reallocation_profiler.h"
+#include "static_vector.h"
 #include "vector.h"
+#include "vector_sort.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <iostream>
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
 #include <stdexcept>
 #include <string>
+#include <thread>
+
+#ifdef VECTOR_ASAN_ANNOTATIONS
+#include <sanitizer/asan_interface.h>
+#endif
 
 namespace {
 
@@ -62,8 +86,21 @@ namespace {
             ++num_moved;
         }
 
-        Obj& operator=(const Obj& other) = default;
-        Obj& operator=(Obj&& other) = default;
+        Obj& operator=(const Obj& other) {
+            throw_on_copy = other.throw_on_copy;
+            id = other.id;
+            name = other.name;
+            ++num_copy_assigned;
+            return *this;
+        }
+
+        Obj& operator=(Obj&& other) noexcept {
+            throw_on_copy = other.throw_on_copy;
+            id = other.id;
+            name = std::move(other.name);
+            ++num_move_assigned;
+            return *this;
+        }
 
         ~Obj() {
             ++num_destroyed;
@@ -80,6 +117,8 @@ namespace {
             num_default_constructed = 0;
             num_copied = 0;
             num_moved = 0;
+            num_copy_assigned = 0;
+            num_move_assigned = 0;
             num_destroyed = 0;
             num_constructed_with_id = 0;
             num_constructed_with_id_and_name = 0;
@@ -95,11 +134,217 @@ namespace {
         static inline int num_constructed_with_id_and_name = 0;
         static inline int num_copied = 0;
         static inline int num_moved = 0;
+        static inline int num_copy_assigned = 0;
+        static inline int num_move_assigned = 0;
         static inline int num_destroyed = 0;
     };
 
+    //   noexcept  Vector    
+    struct ThrowingMoveObj {
+        explicit ThrowingMoveObj(int id)
+            : obj(id) {
+        }
+        ThrowingMoveObj(const ThrowingMoveObj& other) = default;
+        ThrowingMoveObj(ThrowingMoveObj&& other) noexcept(false)
+            : obj(std::move(other.obj)) {
+        }
+        ThrowingMoveObj& operator=(const ThrowingMoveObj& other) = default;
+        ThrowingMoveObj& operator=(ThrowingMoveObj&& other) = default;
+
+        Obj obj;
+    };
+
+    //  ,     
+    struct ThrowingMoveOnlyObj {
+        explicit ThrowingMoveOnlyObj(int id)
+            : obj(id) {
+        }
+        ThrowingMoveOnlyObj(const ThrowingMoveOnlyObj& other) = delete;
+        ThrowingMoveOnlyObj(ThrowingMoveOnlyObj&& other) noexcept(false)
+            : obj(other.throw_on_move ? throw std::runtime_error("Oops") : std::move(other.obj)) {
+        }
+        ThrowingMoveOnlyObj& operator=(const ThrowingMoveOnlyObj& other) = delete;
+        ThrowingMoveOnlyObj& operator=(ThrowingMoveOnlyObj&& other) = default;
+
+        Obj obj;
+        bool throw_on_move = false;
+    };
+
+    // ,     ,   :  
+    // .    ,       
+    struct ThrowingCopyObj {
+        explicit ThrowingCopyObj(int id) noexcept
+            : id(id) {
+            ++num_alive;
+        }
+        ThrowingCopyObj(const ThrowingCopyObj& other)
+            : id(other.throw_on_copy ? throw std::runtime_error("Oops") : other.id) {
+            ++num_alive;
+        }
+        ThrowingCopyObj& operator=(const ThrowingCopyObj& other) = default;
+        ~ThrowingCopyObj() {
+            --num_alive;
+        }
+
+        static inline std::atomic<int> num_alive{ 0 };
+
+        int id;
+        bool throw_on_copy = false;
+    };
+
+    // ,    ,   copy_throw_countdown   .
+    //         
+    struct ThrowingCopyString {
+        ThrowingCopyString(const char* value)
+            : value(value) {
+        }
+        ThrowingCopyString(const ThrowingCopyString& other)
+            : value(other.value) {
+            if (copy_throw_countdown > 0 && --copy_throw_countdown == 0) {
+                throw std::runtime_error("Oops");
+            }
+        }
+        ThrowingCopyString(ThrowingCopyString&& other) noexcept = default;
+        ThrowingCopyString& operator=(const ThrowingCopyString& other) {
+            return *this = ThrowingCopyString(other);
+        }
+        ThrowingCopyString& operator=(ThrowingCopyString&& other) noexcept = default;
+
+        static inline int copy_throw_countdown = 0;
+
+        std::string value;
+    };
+
+    //    ,   operator new/delete .
+    // ,         
+    struct HeapCounter {
+        static void ResetCounters() {
+            num_allocations = 0;
+            num_bytes_allocated = 0;
+        }
+
+        static inline std::atomic<int> num_allocations{ 0 };
+        static inline std::atomic<size_t> num_bytes_allocated{ 0 };
+    };
+
+    [[gnu::noinline]] void* CountedAllocate(size_t size) noexcept {
+        HeapCounter::num_allocations.fetch_add(1, std::memory_order_relaxed);
+        HeapCounter::num_bytes_allocated.fetch_add(size, std::memory_order_relaxed);
+        return std::malloc(size == 0 ? 1 : size);
+    }
+
+    //   malloc:       
+    [[gnu::noinline]] void* CountedAllocateAligned(size_t size, std::align_val_t alignment) noexcept {
+        const size_t align = static_cast<size_t>(alignment);
+        HeapCounter::num_allocations.fetch_add(1, std::memory_order_relaxed);
+        HeapCounter::num_bytes_allocated.fetch_add(size, std::memory_order_relaxed);
+        void* raw = std::malloc(size + align + sizeof(void*));
+        if (raw == nullptr) {
+            return nullptr;
+        }
+        const uintptr_t address = (reinterpret_cast<uintptr_t>(raw) + sizeof(void*) + align - 1) & ~(align - 1);
+        reinterpret_cast<void**>(address)[-1] = raw;
+        return reinterpret_cast<void*>(address);
+    }
+
+    void FreeAligned(void* ptr) noexcept {
+        if (ptr != nullptr) {
+            std::free(static_cast<void**>(ptr)[-1]);
+        }
+    }
+
+    void* CheckedAllocation(void* ptr) {
+        if (ptr == nullptr) {
+            throw std::bad_alloc();
+        }
+        return ptr;
+    }
+
 }  // namespace
 
+//   operator new/delete,   .  malloc  
+// new,  free   delete  :  GCC   malloc  delete
+//  new  free   -Wmismatched-new-delete,   new/delete  
+void* operator new(size_t size) {
+    return CheckedAllocation(CountedAllocate(size));
+}
+
+void* operator new[](size_t size) {
+    return CheckedAllocation(CountedAllocate(size));
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return CountedAllocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return CountedAllocate(size);
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    return CheckedAllocation(CountedAllocateAligned(size, alignment));
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+    return CheckedAllocation(CountedAllocateAligned(size, alignment));
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return CountedAllocateAligned(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return CountedAllocateAligned(size, alignment);
+}
+
+[[gnu::noinline]] void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+[[gnu::noinline]] void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+[[gnu::noinline]] void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+[[gnu::noinline]] void operator delete[](void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+[[gnu::noinline]] void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+    std::free(ptr);
+}
+
+[[gnu::noinline]] void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+    std::free(ptr);
+}
+
+[[gnu::noinline]] void operator delete(void* ptr, std::align_val_t) noexcept {
+    FreeAligned(ptr);
+}
+
+[[gnu::noinline]] void operator delete[](void* ptr, std::align_val_t) noexcept {
+    FreeAligned(ptr);
+}
+
+[[gnu::noinline]] void operator delete(void* ptr, size_t, std::align_val_t) noexcept {
+    FreeAligned(ptr);
+}
+
+[[gnu::noinline]] void operator delete[](void* ptr, size_t, std::align_val_t) noexcept {
+    FreeAligned(ptr);
+}
+
+[[gnu::noinline]] void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept {
+    FreeAligned(ptr);
+}
+
+[[gnu::noinline]] void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept {
+    FreeAligned(ptr);
+}
+
 void Test1() {
     Obj::ResetCounters();
     const size_t SIZE = 100500;
@@ -385,6 +630,1567 @@ void Test5() {
     }
 }
 
+namespace {
+
+    //   :       
+    struct OperationCost {
+        int allocations = 0;
+        size_t bytes_allocated = 0;
+        int constructed = 0;
+        int copied = 0;
+        int moved = 0;
+        int copy_assigned = 0;
+        int move_assigned = 0;
+        int destroyed = 0;
+
+        static OperationCost Current() {
+            return { HeapCounter::num_allocations, HeapCounter::num_bytes_allocated,
+                Obj::num_default_constructed + Obj::num_constructed_with_id + Obj::num_constructed_with_id_and_name,
+                Obj::num_copied, Obj::num_moved, Obj::num_copy_assigned, Obj::num_move_assigned, Obj::num_destroyed };
+        }
+
+        bool operator==(const OperationCost& rhs) const {
+            return allocations == rhs.allocations && bytes_allocated == rhs.bytes_allocated
+                && constructed == rhs.constructed && copied == rhs.copied && moved == rhs.moved
+                && copy_assigned == rhs.copy_assigned && move_assigned == rhs.move_assigned
+                && destroyed == rhs.destroyed;
+        }
+    };
+
+    std::ostream& operator<<(std::ostream& out, const OperationCost& cost) {
+        return out << "{allocations: " << cost.allocations << ", bytes: " << cost.bytes_allocated
+            << ", constructed: " << cost.constructed << ", copied: " << cost.copied
+            << ", moved: " << cost.moved << ", copy_assigned: " << cost.copy_assigned
+            << ", move_assigned: " << cost.move_assigned << ", destroyed: " << cost.destroyed << "}";
+    }
+
+    void ResetCostCounters() {
+        const int countdown = Obj::default_construction_throw_countdown;
+        Obj::ResetCounters();
+        Obj::default_construction_throw_countdown = countdown;
+        HeapCounter::ResetCounters();
+    }
+
+    void AssertCost(const char* name, const OperationCost& expected, const OperationCost& actual) {
+        if (!(expected == actual)) {
+            std::cerr << name << ": expected " << expected << ", got " << actual << std::endl;
+            assert(false && "Operation cost contract violated");
+        }
+    }
+
+    constexpr int ID = 42;
+
+    //     operator new  Vector<Obj>  n:  
+    //     
+    size_t BufferBytes(size_t n) {
+#ifdef VECTOR_BUFFER_CACHE
+        return BufferCache::ClassSize(n * sizeof(Obj));
+#else
+        return n * sizeof(Obj);
+#endif
+    }
+
+    bool ById(const Obj& lhs, const Obj& rhs) noexcept {
+        return lhs.id < rhs.id;
+    }
+
+    //   size   capacity,  Obj  id 0..size-1
+    Vector<Obj> MakeVector(size_t size, size_t capacity) {
+        Vector<Obj> v;
+        v.Reserve(capacity);
+        for (size_t i = 0; i < size; ++i) {
+            v.EmplaceBack(static_cast<int>(i));
+        }
+        return v;
+    }
+
+    struct VectorCostCase {
+        const char* name;
+        size_t size;
+        size_t capacity;
+        size_t other_size;
+        void (*operation)(Vector<Obj>& v, Vector<Obj>& other, Obj& value);
+        OperationCost expected;
+    };
+
+    //  expected: allocations, bytes, constructed, copied, moved, copy_assigned, move_assigned, destroyed.
+    //   ,   ,    
+    const VectorCostCase VECTOR_COST_CASES[] = {
+        { "Reserve, no growth", 4, 8, 0, [](Vector<Obj>& v, Vector<Obj>&, Obj&) { v.Reserve(8); },
+            { 0, 0, 0, 0, 0, 0, 0, 0 } },
+        { "Reserve, growth", 4, 4, 0, [](Vector<Obj>& v, Vector<Obj>&, Obj&) { v.Reserve(8); },
+            { 1, BufferBytes(8), 0, 0, 4, 0, 0, 4 } },
+        { "PushBack copy, empty", 0, 0, 0, [](Vector<Obj>& v, Vector<Obj>&, Obj& value) { v.PushBack(value); },
+            { 1, BufferBytes(1), 0, 1, 0, 0, 0, 0 } },
+        { "PushBack copy, in capacity", 4, 8, 0, [](Vector<Obj>& v, Vector<Obj>&, Obj& value) { v.PushBack(value); },
+            { 0, 0, 0, 1, 0, 0, 0, 0 } },
+        { "PushBack copy, growth", 4, 4, 0, [](Vector<Obj>& v, Vector<Obj>&, Obj& value) { v.PushBack(value); },
+            { 1, BufferBytes(8), 0, 1, 4, 0, 0, 4 } },
+        { "PushBack move, growth", 4, 4, 0, [](Vector<Obj>& v, Vector<Obj>&, Obj& value) { v.PushBack(std::move(value)); },
+            { 1, BufferBytes(8), 0, 0, 5, 0, 0, 4 } },
+        { "EmplaceBack, in capacity", 4, 8, 0, [](Vector<Obj>& v, Vector<Obj>&, Obj&) { v.EmplaceBack(ID); },
+            { 0, 0, 1, 0, 0, 0, 0, 0 } },
+        { "EmplaceBack, growth", 4, 4, 0, [](Vector<Obj>& v, Vector<Obj>&, Obj&) { v.EmplaceBack(ID); },
+            { 1, BufferBytes(8), 1, 0, 4, 0, 0, 4 } },
+        { "Emplace at end, in capacity", 4, 8, 0, [](Vector<Obj>& v, Vector<Obj>&, Obj&) { v.Emplace(v.end(), ID); },
+            { 0, 0, 1, 0, 0, 0, 0, 0 } },
+        { "Emplace in middle, in capacity", 4, 8, 0, [](Vector<Obj>& v, Vector<Obj>&, Obj&) { v.Emplace(v.begin() + 1, ID); },
+            { 0, 0, 1, 0, 1, 0, 2, 1 } },
+        { "Emplace with string in middle, in capacity", 4, 8, 0,
+            [](Vector<Obj>& v, Vector<Obj>&, Obj&) { v.Emplace(v.begin() + 1, ID, std::string("Ivan")); },
+            { 0, 0, 1, 0, 1, 0, 3, 1 } },
+        { "Emplace in middle, growth", 4, 4, 0, [](Vector<Obj>& v, Vector<Obj>&, Obj&) { v.Emplace(v.begin() + 1, ID); },
+            { 1, BufferBytes(8), 1, 0, 4, 0, 0, 4 } },
+        { "Insert copy in middle, in capacity", 4, 8, 0, [](Vector<Obj>& v, Vector<Obj>&, Obj& value) { v.Insert(v.begin() + 1, value); },
+            { 0, 0, 0, 0, 1, 1, 2, 0 } },
+        { "Insert move in middle, in capacity", 4, 8, 0, [](Vector<Obj>& v, Vector<Obj>&, Obj& value) { v.Insert(v.begin() + 1, std::move(value)); },
+            { 0, 0, 0, 0, 1, 0, 3, 0 } },
+        { "Insert own element in middle, in capacity", 4, 8, 0, [](Vector<Obj>& v, Vector<Obj>&, Obj&) { v.Insert(v.begin() + 1, v[3]); },
+            { 0, 0, 0, 1, 1, 0, 3, 1 } },
+        { "Insert copy in middle, growth", 4, 4, 0, [](Vector<Obj>& v, Vector<Obj>&, Obj& value) { v.Insert(v.begin() + 1, value); },
+            { 1, BufferBytes(8), 0, 1, 4, 0, 0, 4 } },
+        { "InsertSorted, in capacity", 4, 8, 3, [](Vector<Obj>& v, Vector<Obj>& other, Obj&) { v.InsertSorted(other.begin(), other.end(), ById); },
+            { 1, BufferBytes(8), 0, 3, 4, 0, 3, 4 } },
+        { "InsertSorted moved, in capacity", 4, 8, 3, [](Vector<Obj>& v, Vector<Obj>& other, Obj&) {
+             v.InsertSorted(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()), ById);
+         },
+            { 0, 0, 0, 0, 3, 0, 3, 0 } },
+        { "InsertSorted, growth", 4, 4, 3, [](Vector<Obj>& v, Vector<Obj>& other, Obj&) { v.InsertSorted(other.begin(), other.end(), ById); },
+            { 1, BufferBytes(8), 0, 3, 4, 0, 3, 4 } },
+        { "Erase in middle", 4, 8, 0, [](Vector<Obj>& v, Vector<Obj>&, Obj&) { v.Erase(v.begin() + 1); },
+            { 0, 0, 0, 0, 0, 0, 2, 1 } },
+        { "PopBack", 4, 8, 0, [](Vector<Obj>& v, Vector<Obj>&, Obj&) { v.PopBack(); },
+            { 0, 0, 0, 0, 0, 0, 0, 1 } },
+        { "Resize, shrink", 4, 8, 0, [](Vector<Obj>& v, Vector<Obj>&, Obj&) { v.Resize(2); },
+            { 0, 0, 0, 0, 0, 0, 0, 2 } },
+        { "Resize, grow in capacity", 4, 8, 0, [](Vector<Obj>& v, Vector<Obj>&, Obj&) { v.Resize(6); },
+            { 0, 0, 2, 0, 0, 0, 0, 0 } },
+        { "Resize, growth", 4, 4, 0, [](Vector<Obj>& v, Vector<Obj>&, Obj&) { v.Resize(6); },
+            { 1, BufferBytes(6), 2, 0, 4, 0, 0, 4 } },
+        { "Copy constructor", 4, 8, 0, [](Vector<Obj>& v, Vector<Obj>&, Obj&) { Vector<Obj> copy(v); },
+            { 1, BufferBytes(4), 0, 4, 0, 0, 0, 4 } },
+        { "Move constructor", 4, 8, 0, [](Vector<Obj>& v, Vector<Obj>&, Obj&) { Vector<Obj> moved(std::move(v)); },
+            { 0, 0, 0, 0, 0, 0, 0, 4 } },
+        { "Copy assignment, shrink", 4, 8, 2, [](Vector<Obj>& v, Vector<Obj>& other, Obj&) { v = other; },
+            { 0, 0, 0, 0, 0, 2, 0, 2 } },
+        { "Copy assignment, grow in capacity", 2, 8, 4, [](Vector<Obj>& v, Vector<Obj>& other, Obj&) { v = other; },
+            { 0, 0, 0, 2, 0, 2, 0, 0 } },
+        { "Copy assignment, growth", 2, 2, 4, [](Vector<Obj>& v, Vector<Obj>& other, Obj&) { v = other; },
+            { 1, BufferBytes(4), 0, 4, 0, 0, 0, 2 } },
+        { "Move assignment", 4, 8, 2, [](Vector<Obj>& v, Vector<Obj>& other, Obj&) { v = std::move(other); },
+            { 0, 0, 0, 0, 0, 0, 0, 4 } },
+        { "Swap", 4, 8, 2, [](Vector<Obj>& v, Vector<Obj>& other, Obj&) { v.Swap(other); },
+            { 0, 0, 0, 0, 0, 0, 0, 0 } },
+    };
+
+    struct OptionalCostCase {
+        const char* name;
+        bool engaged;
+        bool other_engaged;
+        void (*operation)(Optional<Obj>& opt, Optional<Obj>& other);
+        OperationCost expected;
+    };
+
+    const OptionalCostCase OPTIONAL_COST_CASES[] = {
+        { "Assign value, empty", false, true, [](Optional<Obj>& opt, Optional<Obj>& other) { opt = *other; },
+            { 0, 0, 0, 1, 0, 0, 0, 0 } },
+        { "Assign value, engaged", true, true, [](Optional<Obj>& opt, Optional<Obj>& other) { opt = *other; },
+            { 0, 0, 0, 0, 0, 1, 0, 0 } },
+        { "Assign rvalue, empty", false, true, [](Optional<Obj>& opt, Optional<Obj>& other) { opt = std::move(*other); },
+            { 0, 0, 0, 0, 1, 0, 0, 0 } },
+        { "Assign rvalue, engaged", true, true, [](Optional<Obj>& opt, Optional<Obj>& other) { opt = std::move(*other); },
+            { 0, 0, 0, 0, 0, 0, 1, 0 } },
+        { "Copy assignment, empty from engaged", false, true, [](Optional<Obj>& opt, Optional<Obj>& other) { opt = other; },
+            { 0, 0, 0, 1, 0, 0, 0, 0 } },
+        { "Copy assignment, engaged from engaged", true, true, [](Optional<Obj>& opt, Optional<Obj>& other) { opt = other; },
+            { 0, 0, 0, 0, 0, 1, 0, 0 } },
+        { "Copy assignment, engaged from empty", true, false, [](Optional<Obj>& opt, Optional<Obj>& other) { opt = other; },
+            { 0, 0, 0, 0, 0, 0, 0, 1 } },
+        { "Move assignment, empty from engaged", false, true, [](Optional<Obj>& opt, Optional<Obj>& other) { opt = std::move(other); },
+            { 0, 0, 0, 0, 1, 0, 0, 0 } },
+        { "Move assignment, engaged from engaged", true, true, [](Optional<Obj>& opt, Optional<Obj>& other) { opt = std::move(other); },
+            { 0, 0, 0, 0, 0, 0, 1, 0 } },
+        { "Move assignment, engaged from empty", true, false, [](Optional<Obj>& opt, Optional<Obj>& other) { opt = std::move(other); },
+            { 0, 0, 0, 0, 0, 0, 0, 1 } },
+        { "Copy constructor", false, true, [](Optional<Obj>&, Optional<Obj>& other) { Optional<Obj> copy(other); },
+            { 0, 0, 0, 1, 0, 0, 0, 1 } },
+        { "Move constructor", false, true, [](Optional<Obj>&, Optional<Obj>& other) { Optional<Obj> moved(std::move(other)); },
+            { 0, 0, 0, 0, 1, 0, 0, 1 } },
+        { "Emplace, engaged", true, false, [](Optional<Obj>& opt, Optional<Obj>&) { opt.Emplace(ID); },
+            { 0, 0, 1, 0, 0, 0, 0, 1 } },
+        { "Reset, engaged", true, false, [](Optional<Obj>& opt, Optional<Obj>&) { opt.Reset(); },
+            { 0, 0, 0, 0, 0, 0, 0, 1 } },
+        { "Reset, empty", false, false, [](Optional<Obj>& opt, Optional<Obj>&) { opt.Reset(); },
+            { 0, 0, 0, 0, 0, 0, 0, 0 } },
+    };
+
+}  // namespace
+
+//    Vector  Optional:       
+void Test6() {
+#ifdef VECTOR_BUFFER_CACHE
+    //     operator new,      
+    BufferCache& cache = BufferCache::Local();
+    const size_t old_limit = cache.ByteLimit();
+    cache.SetByteLimit(0);
+    BufferCache::SetSharedByteLimit(0);
+#endif
+    for (const VectorCostCase& test_case : VECTOR_COST_CASES) {
+        {
+            Vector<Obj> v = MakeVector(test_case.size, test_case.capacity);
+            Vector<Obj> other = MakeVector(test_case.other_size, test_case.other_size);
+            Obj value{ ID };
+            ResetCostCounters();
+            test_case.operation(v, other, value);
+            AssertCost(test_case.name, test_case.expected, OperationCost::Current());
+        }
+        // v, other  value    ,       :
+        //  ,       ,  
+        const int existed_before_reset = static_cast<int>(test_case.size + test_case.other_size + 1);
+        assert(Obj::GetAliveObjectCount() + existed_before_reset == 0);
+    }
+    for (const OptionalCostCase& test_case : OPTIONAL_COST_CASES) {
+        Optional<Obj> opt;
+        if (test_case.engaged) {
+            opt.Emplace(1);
+        }
+        Optional<Obj> other;
+        if (test_case.other_engaged) {
+            other.Emplace(2);
+        }
+        ResetCostCounters();
+        test_case.operation(opt, other);
+        AssertCost(test_case.name, test_case.expected, OperationCost::Current());
+    }
+#ifdef VECTOR_BUFFER_CACHE
+    cache.SetByteLimit(old_limit);
+    BufferCache::SetSharedByteLimit(BufferCache::DEFAULT_SHARED_BYTE_LIMIT);
+#endif
+}
+
+void Test7() {
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v = MakeVector(4, 8);
+        //          
+        Obj::default_construction_throw_countdown = 1;
+        try {
+            v.Emplace(v.begin() + 1);
+            assert(false && "Exception is expected");
+        }
+        catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == 4);
+        for (size_t i = 0; i < v.Size(); ++i) {
+            assert(v[i].id == static_cast<int>(i));
+        }
+        assert(Obj::GetAliveObjectCount() == 4);
+    }
+    {
+        Vector<TestObj> v(1);
+        v.Reserve(4);
+        v.EmplaceBack();
+        //  Insert         
+        v.Insert(v.begin(), v[1]);
+        assert(v[0].IsAlive());
+        assert(v[1].IsAlive());
+        assert(v[2].IsAlive());
+    }
+    {
+        //     :      
+        Vector<std::string> v;
+        v.Reserve(4);
+        v.PushBack("ab");
+        v.PushBack("cd");
+        v.Emplace(v.begin(), v[0].c_str());
+        v.Emplace(v.begin() + 1, std::string_view(v[2]));
+        assert(v.Size() == 4 && v[0] == "ab" && v[1] == "cd" && v[2] == "ab" && v[3] == "cd");
+    }
+    {
+        Vector<int> v;
+        const int initial[] = { 1, 3, 5, 7 };
+        v.InsertSorted(std::begin(initial), std::end(initial));
+        const int batch[] = { 0, 3, 4, 8, 9 };
+        v.InsertSorted(std::begin(batch), std::end(batch));
+        const int expected[] = { 0, 1, 3, 3, 4, 5, 7, 8, 9 };
+        assert(v.Size() == std::size(expected));
+        assert(std::equal(v.begin(), v.end(), std::begin(expected)));
+    }
+    {
+        //        
+        using Item = std::pair<int, std::string>;
+        Vector<Item> v;
+        v.EmplaceBack(1, "old");
+        v.EmplaceBack(2, "old");
+        const Item batch[] = { { 1, "new" }, { 3, "new" } };
+        const auto by_key = [](const Item& lhs, const Item& rhs) {
+            return lhs.first < rhs.first;
+        };
+        v.InsertSorted(std::begin(batch), std::end(batch), by_key);
+        assert(v.Size() == 4);
+        assert(v[0] == Item(1, "old") && v[1] == Item(1, "new"));
+        assert(v[2] == Item(2, "old") && v[3] == Item(3, "new"));
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v = MakeVector(2, 2);
+        Vector<Obj> batch = MakeVector(2, 2);
+        v.InsertSorted(std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()), ById);
+        assert(v.Size() == 4);
+        assert(v[0].id == 0 && v[1].id == 0 && v[2].id == 1 && v[3].id == 1);
+        assert(Obj::num_copied == 0 && Obj::num_copy_assigned == 0);
+    }
+    {
+        //        
+        const auto by_value = [](const ThrowingCopyString& lhs, const ThrowingCopyString& rhs) {
+            return lhs.value < rhs.value;
+        };
+        const ThrowingCopyString batch[] = { "a", "c", "e", "g" };
+        for (int countdown = 1; countdown <= 4; ++countdown) {
+            Vector<ThrowingCopyString> v;
+            v.Reserve(10);
+            for (const char* value : { "b", "d", "f", "h" }) {
+                v.EmplaceBack(value);
+            }
+            ThrowingCopyString::copy_throw_countdown = countdown;
+            try {
+                v.InsertSorted(std::begin(batch), std::end(batch), by_value);
+                assert(false);
+            }
+            catch (const std::runtime_error&) {
+            }
+            assert(v.Size() == 4 && v.Capacity() == 10);
+            assert(v[0].value == "b" && v[1].value == "d" && v[2].value == "f" && v[3].value == "h");
+        }
+        ThrowingCopyString::copy_throw_countdown = 0;
+
+        //      
+        Vector<ThrowingCopyString> v;
+        v.Reserve(10);
+        for (const char* value : { "b", "d", "f", "h" }) {
+            v.EmplaceBack(value);
+        }
+        int compare_countdown = 3;
+        const auto throwing_by_value = [&compare_countdown](const ThrowingCopyString& lhs, const ThrowingCopyString& rhs) {
+            if (--compare_countdown == 0) {
+                throw std::runtime_error("Oops");
+            }
+            return lhs.value < rhs.value;
+        };
+        try {
+            v.InsertSorted(std::begin(batch), std::end(batch), throwing_by_value);
+            assert(false);
+        }
+        catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == 4 && v.Capacity() == 10);
+        assert(v[0].value == "b" && v[1].value == "d" && v[2].value == "f" && v[3].value == "h");
+    }
+}
+
+void Test8() {
+    using namespace std::literals;
+    {
+        FlatSet<int> set;
+        assert(set.Insert(5));
+        assert(set.Insert(1));
+        assert(!set.Insert(5));
+        const int batch[] = { 7, 3, 1, 3, 9 };
+        set.InsertRange(std::begin(batch), std::end(batch));
+        const int expected[] = { 1, 3, 5, 7, 9 };
+        assert(set.Size() == std::size(expected));
+        assert(std::equal(set.begin(), set.end(), std::begin(expected)));
+        assert(set.Contains(7) && !set.Contains(4));
+        assert(*set.LowerBound(4) == 5);
+        assert(set.LowerBound(10) == set.end());
+        assert(set.Erase(3) && !set.Erase(3));
+        assert(set.Size() == 4);
+    }
+    {
+        FlatMap<std::string, int, std::less<>> map;
+        assert(map.Insert("b"s, 2));
+        assert(!map.Insert("b"s, 20));
+        map["a"s] = 1;
+        assert(map.At("b"s) == 2);
+        //      
+        assert(map.Contains("a"sv));
+        assert(*map.Find("a"sv) == 1);
+        assert(map.Find("z"sv) == nullptr);
+
+        const std::pair<std::string, int> batch[] = { { "d"s, 4 }, { "c"s, 3 }, { "b"s, 200 }, { "d"s, 40 } };
+        map.InsertRange(std::begin(batch), std::end(batch));
+        assert(map.Size() == 4);
+        const std::string expected_keys[] = { "a"s, "b"s, "c"s, "d"s };
+        const int expected_values[] = { 1, 2, 3, 4 };
+        assert(std::equal(map.Keys().begin(), map.Keys().end(), std::begin(expected_keys)));
+        assert(std::equal(map.Values().begin(), map.Values().end(), std::begin(expected_values)));
+
+        assert(map.Erase("c"s) && !map.Erase("c"s));
+        assert(map.Size() == 3 && map.At("d"s) == 4);
+        try {
+            map.At("c"s);
+            assert(false && "Exception is expected");
+        }
+        catch (const std::out_of_range&) {
+        }
+    }
+    {
+        //         
+        bool armed = false;
+        const auto throwing_less = [&armed](const std::string& lhs, const std::string& rhs) {
+            if (armed && (lhs == "e" || rhs == "e")) {
+                throw std::runtime_error("Oops");
+            }
+            return lhs < rhs;
+        };
+        FlatMap<std::string, std::string, decltype(throwing_less)> map(throwing_less);
+        for (const char* key : { "a", "c", "e" }) {
+            map.Insert(std::string(key), key + "!"s);
+        }
+        armed = true;
+        const std::pair<std::string, std::string> batch[] = { { "f"s, "f!"s }, { "b"s, "b!"s }, { "d"s, "d!"s } };
+        try {
+            map.InsertRange(std::begin(batch), std::end(batch));
+            assert(false && "Exception is expected");
+        }
+        catch (const std::runtime_error&) {
+        }
+        armed = false;
+        const std::string expected_keys[] = { "a"s, "c"s, "e"s };
+        const std::string expected_values[] = { "a!"s, "c!"s, "e!"s };
+        assert(map.Size() == 3);
+        assert(std::equal(map.Keys().begin(), map.Keys().end(), std::begin(expected_keys)));
+        assert(std::equal(map.Values().begin(), map.Values().end(), std::begin(expected_values)));
+    }
+    {
+        Obj::ResetCounters();
+        {
+            FlatMap<int, Obj> map;
+            for (int i = 100; i > 0; --i) {
+                map.TryEmplace(i, i);
+            }
+            assert(map.Size() == 100);
+            for (int i = 1; i <= 100; ++i) {
+                assert(map.At(i).id == i);
+            }
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+}
+
+void Test9() {
+    using namespace std::literals;
+    {
+        FlatHashMap<std::string, int> map;
+        assert(map.IsEmpty() && map.Capacity() == 0);
+        assert(map.Find("a"s) == nullptr);
+        assert(map.Insert("a"s, 1));
+        assert(!map.Insert("a"s, 2));
+        map["b"s] = 2;
+        assert(map.Size() == 2);
+        assert(*map.Find("a"s) == 1 && *map.Find("b"s) == 2);
+        assert(map.Erase("a"s) && !map.Erase("a"s));
+        assert(!map.Contains("a"s) && map.Contains("b"s));
+
+        FlatHashMap<std::string, int> copy(map);
+        map.Clear();
+        assert(map.IsEmpty() && !map.Contains("b"s));
+        assert(copy.Size() == 1 && *copy.Find("b"s) == 2);
+    }
+    {
+        //       std::unordered_map
+        FlatHashMap<int, int> map;
+        std::unordered_map<int, int> reference;
+        std::mt19937 generator(42);
+        for (int i = 0; i < 50'000; ++i) {
+            const int key = static_cast<int>(generator() % 2'000);
+            if (generator() % 3 == 0) {
+                assert(map.Erase(key) == (reference.erase(key) == 1));
+            }
+            else {
+                assert(map.Insert(key, i) == reference.emplace(key, i).second);
+            }
+            assert(map.Size() == reference.size());
+        }
+        for (int key = 0; key < 2'000; ++key) {
+            const auto it = reference.find(key);
+            const int* value = map.Find(key);
+            assert((it == reference.end()) == (value == nullptr));
+            assert(value == nullptr || *value == it->second);
+        }
+        size_t visited = 0;
+        map.ForEach([&](int key, int value) {
+            assert(reference.at(key) == value);
+            ++visited;
+        });
+        assert(visited == reference.size());
+    }
+    {
+        Obj::ResetCounters();
+        {
+            FlatHashMap<int, Obj> map;
+            map.Reserve(100);
+            const size_t capacity = map.Capacity();
+            for (int i = 0; i < 100; ++i) {
+                map.TryEmplace(i, i);
+            }
+            assert(map.Capacity() == capacity);
+            assert(Obj::num_moved == 0);
+            for (int i = 0; i < 1000; ++i) {
+                map.TryEmplace(i, i);
+            }
+            for (int i = 0; i < 1000; i += 2) {
+                assert(map.Erase(i));
+            }
+            assert(map.Size() == 500);
+            assert(Obj::GetAliveObjectCount() == 500);
+            for (int i = 1; i < 1000; i += 2) {
+                assert(map.Find(i)->id == i);
+            }
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        // ,    ,    H2,   
+        // ,      
+        const size_t KEYS = 1024;
+        for (const unsigned shift : { 20u, 40u, 56u }) {
+            std::unordered_set<uint64_t> tags;
+            std::unordered_set<uint64_t> homes;
+            size_t keys = 0;
+            for (uint64_t i = 0; i < KEYS && (i << shift >> shift) == i; ++i, ++keys) {
+                const uint64_t hash = flat_hash_detail::Mix(static_cast<size_t>(i << shift));
+                tags.insert(hash & 0x7F);
+                homes.insert(hash >> 7 & (KEYS - 1));
+            }
+            assert(tags.size() >= 64 && homes.size() >= keys / 4);
+        }
+
+        FlatHashMap<uint64_t, uint64_t> map;
+        for (uint64_t i = 0; i < 20'000; ++i) {
+            assert(map.Insert(i << 40, i));
+        }
+        for (uint64_t i = 0; i < 20'000; ++i) {
+            assert(*map.Find(i << 40) == i);
+        }
+    }
+}
+
+void Test10() {
+    {
+        CircularVector<int> queue;
+        assert(queue.IsEmpty() && queue.Capacity() == 0);
+        for (int i = 0; i < 5; ++i) {
+            queue.PushBack(i);
+        }
+        assert(queue.Capacity() == 8);
+        queue.PopFront();
+        queue.PopFront();
+        queue.PushFront(1);
+        queue.PushFront(0);
+        queue.PushFront(-1);
+        //       
+        assert(queue.Size() == 6 && queue.Capacity() == 8);
+        queue.PushBack(5);
+        queue.PushBack(6);
+        assert(queue.Capacity() == 8);
+        //      
+        queue.PushBack(7);
+        assert(queue.Capacity() == 16);
+        for (size_t i = 0; i < queue.Size(); ++i) {
+            assert(queue[i] == static_cast<int>(i) - 1);
+        }
+        assert(queue.Front() == -1 && queue.Back() == 7);
+
+        const CircularVector<int> copy(queue);
+        assert(copy.Size() == queue.Size());
+        for (size_t i = 0; i < copy.Size(); ++i) {
+            assert(copy[i] == queue[i]);
+        }
+        queue.PopBack();
+        assert(queue.Back() == 6);
+    }
+    {
+        Obj::ResetCounters();
+        {
+            CircularVector<Obj> queue;
+            queue.Reserve(4);
+            for (int i = 0; i < 100; ++i) {
+                queue.EmplaceBack(i);
+                queue.EmplaceFront(-i);
+                queue.PopFront();
+            }
+            assert(queue.Size() == 100);
+            assert(Obj::GetAliveObjectCount() == 100);
+            for (size_t i = 0; i < queue.Size(); ++i) {
+                assert(queue[i].id == static_cast<int>(i));
+            }
+            //    ,   
+            assert(Obj::num_copied == 0);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        Obj::ResetCounters();
+        CircularVector<Obj> queue;
+        queue.EmplaceBack(1);
+        queue.EmplaceBack(2);
+        Obj::default_construction_throw_countdown = 1;
+        try {
+            queue.EmplaceFront();
+            assert(false && "Exception is expected");
+        }
+        catch (const std::runtime_error&) {
+        }
+        assert(queue.Size() == 2 && queue.Capacity() == 2);
+        assert(queue[0].id == 1 && queue[1].id == 2);
+        assert(Obj::GetAliveObjectCount() == 2);
+    }
+    {
+        CircularVector<TestObj> queue;
+        queue.EmplaceBack();
+        //         
+        queue.PushFront(queue[0]);
+        queue.PushBack(queue[1]);
+        assert(queue[0].IsAlive() && queue[1].IsAlive() && queue[2].IsAlive());
+    }
+    {
+        //     :    
+        Obj::ResetCounters();
+        {
+            CircularVector<ThrowingMoveOnlyObj> queue;
+            queue.Reserve(4);
+            queue.EmplaceBack(1);
+            queue.EmplaceBack(2);
+            queue.EmplaceFront(0);
+            queue[2].throw_on_move = true;
+            try {
+                queue.Reserve(8);
+                assert(false && "Exception is expected");
+            }
+            catch (const std::runtime_error&) {
+            }
+            assert(queue.Size() == 3 && queue.Capacity() == 4);
+            assert(Obj::GetAliveObjectCount() == 3);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+}
+
+void Test11() {
+    BufferCache& cache = BufferCache::Local();
+    const size_t old_limit = cache.ByteLimit();
+    //     :  VECTOR_BUFFER_CACHE     
+    cache.SetByteLimit(0);
+    BufferCache::SetSharedByteLimit(0);
+    BufferCache::SetSharedByteLimit(BufferCache::DEFAULT_SHARED_BYTE_LIMIT);
+    cache.SetByteLimit(1024);
+    cache.ResetStats();
+    {
+        assert(BufferCache::ClassSize(1) == 16);
+        assert(BufferCache::ClassSize(100) == 128);
+        assert(BufferCache::ClassSize(128) == 128);
+
+        //         
+        void* buffer = cache.Allocate(100);
+        cache.Deallocate(buffer, 100);
+        assert(cache.CachedBytes() == 128);
+        void* reused = cache.Allocate(120);
+        assert(reused == buffer);
+        assert(cache.CachedBytes() == 0);
+        cache.Deallocate(reused, 120);
+
+        const BufferCache::Stats& stats = cache.GetStats();
+        assert(stats.misses == 1 && stats.hits == 1 && stats.cached_frees == 2);
+        assert(stats.HitRate() == 0.5);
+    }
+    {
+        //        
+        const size_t shared_bytes = BufferCache::SharedCachedBytes();
+        void* large = cache.Allocate(2048);
+        cache.Deallocate(large, 2048);
+        assert(cache.GetStats().shared_frees == 1);
+        assert(BufferCache::SharedCachedBytes() == shared_bytes + 2048);
+        assert(cache.Allocate(2000) == large);
+        assert(cache.GetStats().shared_hits == 1);
+        cache.Deallocate(large, 2000);
+    }
+    {
+        // ,    ,      
+        BufferCache::SetSharedByteLimit(0);
+        BufferCache::SetSharedByteLimit(BufferCache::DEFAULT_SHARED_BYTE_LIMIT);
+        void* buffer = cache.Allocate(512);
+        std::thread([buffer] {
+            BufferCache::DeallocateBuffer(buffer, 512);
+        }).join();
+        assert(BufferCache::SharedCachedBytes() == 512);
+        cache.ResetStats();
+        assert(cache.Allocate(300) == buffer);
+        assert(cache.GetStats().shared_hits == 1);
+        cache.Deallocate(buffer, 300);
+    }
+    {
+        //           Flush
+        BufferCache::SetSharedByteLimit(0);
+        BufferCache::SetSharedByteLimit(BufferCache::DEFAULT_SHARED_BYTE_LIMIT);
+        void* buffer = cache.Allocate(256);
+        std::atomic<int> stage{ 0 };
+        std::thread worker([buffer, &stage] {
+            BufferCache::DeallocateBuffer(buffer, 256);
+            BufferCache::Local().Flush();
+            assert(BufferCache::Local().CachedBytes() == 0);
+            stage = 1;
+            while (stage != 2) {
+                std::this_thread::yield();
+            }
+        });
+        while (stage != 1) {
+            std::this_thread::yield();
+        }
+        assert(BufferCache::SharedCachedBytes() == 256);
+        assert(cache.Allocate(200) == buffer);
+        stage = 2;
+        worker.join();
+        cache.Deallocate(buffer, 200);
+    }
+#ifdef VECTOR_BUFFER_CACHE
+    {
+        // Vector    :      
+        //    operator new
+        const auto fill = [] {
+            Vector<int> v;
+            for (int i = 0; i < 200; ++i) {
+                v.PushBack(i);
+            }
+            for (int i = 0; i < 200; ++i) {
+                assert(v[static_cast<size_t>(i)] == i);
+            }
+        };
+        cache.SetByteLimit(BufferCache::DEFAULT_BYTE_LIMIT);
+        fill();
+        cache.ResetStats();
+        const int allocations = HeapCounter::num_allocations;
+        fill();
+        assert(HeapCounter::num_allocations == allocations);
+        assert(cache.GetStats().misses == 0 && cache.GetStats().hits > 0);
+
+        // ,    ,     
+        BufferCache::SetSharedByteLimit(0);
+        BufferCache::SetSharedByteLimit(BufferCache::DEFAULT_SHARED_BYTE_LIMIT);
+        Vector<int> v(1000);
+        v[999] = 7;
+        std::thread([moved = std::move(v)]() mutable {
+            assert(moved.Size() == 1000 && moved[999] == 7);
+            Vector<int>().Swap(moved);
+        }).join();
+        assert(BufferCache::SharedCachedBytes() == BufferCache::ClassSize(1000 * sizeof(int)));
+    }
+#endif
+    cache.SetByteLimit(0);
+    assert(cache.CachedBytes() == 0);
+    BufferCache::SetSharedByteLimit(0);
+    assert(BufferCache::SharedCachedBytes() == 0);
+    cache.SetByteLimit(old_limit);
+    BufferCache::SetSharedByteLimit(BufferCache::DEFAULT_SHARED_BYTE_LIMIT);
+}
+
+namespace {
+
+    // StaticVector        
+    constexpr int SumOfOddSquares() {
+        StaticVector<int, 8> v;
+        for (int i = 0; i < 8; ++i) {
+            v.PushBack(i * i);
+        }
+        for (auto it = v.begin(); it != v.end();) {
+            it = *it % 2 == 0 ? v.Erase(it) : it + 1;
+        }
+        v.Emplace(v.begin(), 100);
+        v.Resize(v.Size() - 1);
+        int sum = 0;
+        for (int value : v) {
+            sum += value;
+        }
+        return sum;
+    }
+
+    static_assert(SumOfOddSquares() == 100 + 1 + 9 + 25);
+    static_assert(std::is_trivially_copyable_v<StaticVector<int, 4>>);
+    static_assert(!std::is_trivially_copyable_v<StaticVector<std::string, 4>>);
+
+    //       ,  
+    //   
+    struct Point {
+        int x = 0;
+        int y = 0;
+    };
+
+    constexpr int SumOfPoints() {
+        StaticVector<Point, 4> v;
+        v.PushBack(Point{ 1, 2 });
+        v.EmplaceBack();
+        v.PushBack(Point{ 3, 4 });
+        const StaticVector<Point, 4> copy = v;
+        int sum = 0;
+        for (const Point& point : copy) {
+            sum += point.x * 10 + point.y;
+        }
+        return sum;
+    }
+
+    static_assert(!std::is_trivially_default_constructible_v<Point>);
+    static_assert(std::is_trivially_copyable_v<StaticVector<Point, 4>>);
+    static_assert(SumOfPoints() == 12 + 34);
+
+}  // namespace
+
+void Test12() {
+    {
+        StaticVector<int, 4> v;
+        assert(v.Capacity() == 4 && v.IsEmpty());
+        v.PushBack(1);
+        v.PushBack(3);
+        v.Insert(v.begin() + 1, 2);
+        assert(v.TryPushBack(4));
+        assert(v.IsFull());
+        assert(!v.TryPushBack(5));
+        assert(!v.TryEmplace(v.begin(), 0));
+        assert(!v.TryResize(5));
+        assert(v.Size() == 4);
+        for (size_t i = 0; i < v.Size(); ++i) {
+            assert(v[i] == static_cast<int>(i) + 1);
+        }
+        const StaticVector<int, 4> copy = v;
+        v.Erase(v.begin());
+        assert(v.Size() == 3 && v[0] == 2);
+        assert(copy.Size() == 4 && copy[0] == 1);
+    }
+    {
+        Obj::ResetCounters();
+        HeapCounter::ResetCounters();
+        {
+            StaticVector<Obj, 8> v;
+            assert(Obj::GetAliveObjectCount() == 0);
+            v.EmplaceBack(1);
+            v.EmplaceBack(3);
+            v.Emplace(v.begin() + 1, 2);
+            v.Resize(5);
+            assert(v.Size() == 5 && v[1].id == 2 && v[4].id == 0);
+            StaticVector<Obj, 8> copy(v);
+            assert(Obj::GetAliveObjectCount() == 10);
+            copy.Resize(2);
+            v = copy;
+            assert(v.Size() == 2 && v[1].id == 2);
+            v.Erase(v.begin());
+            v.PopBack();
+            assert(v.IsEmpty());
+            assert(Obj::GetAliveObjectCount() == 2);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+        assert(HeapCounter::num_allocations == 0);
+    }
+    {
+        StaticVector<TestObj, 4> v;
+        v.EmplaceBack();
+        v.EmplaceBack();
+        //        
+        v.Insert(v.begin(), v[1]);
+        assert(v[0].IsAlive() && v[1].IsAlive() && v[2].IsAlive());
+    }
+}
+
+void Test13() {
+    ReallocationProfiler::Reset();
+    {
+        //       ,     
+        const auto site_of = [](CallSite site = CallSite::Current()) {
+            return site;
+        };
+        const CallSite first = site_of();
+        const CallSite second = site_of();
+        assert(std::string(first.file) == second.file);
+        assert(second.line == first.line + 1);
+    }
+    {
+        const CallSite origin = CallSite::Current();
+        const CallSite reserve_site = CallSite::Current();
+        ReallocationProfiler* profiler = ReallocationProfiler::Local();
+        assert(profiler != nullptr);
+        profiler->RecordGrowth(origin, 0);
+        profiler->RecordGrowth(origin, 8);
+        profiler->RecordFinalSize(origin, 5);
+        profiler->RecordReserve(reserve_site);
+
+        //         ,      
+        std::thread([origin] {
+            ReallocationProfiler::Local()->RecordGrowth(origin, 16);
+            ReallocationProfiler::Local()->RecordFinalSize(origin, 9);
+        }).join();
+
+        const std::vector<ReallocationProfiler::SiteStats> stats = ReallocationProfiler::Collect();
+        assert(stats.size() == 2);
+        const ReallocationProfiler::SiteStats& hot = stats[0];
+        assert(hot.site.line == origin.line);
+        assert(hot.growths == 3 && hot.bytes_moved == 24);
+        assert(hot.vectors == 2 && hot.max_final_size == 9);
+        assert(hot.SuggestedReserve() == 9);
+        assert(stats[1].site.line == reserve_site.line);
+        assert(stats[1].reserves == 1 && stats[1].growths == 0);
+    }
+    ReallocationProfiler::Reset();
+    assert(ReallocationProfiler::Collect().empty());
+}
+
+void Test14() {
+    CapacityAdvisor& advisor = CapacityAdvisor::Local();
+    advisor.Clear();
+    const CallSite batch{ "batch" };
+    const CallSite other{ "other" };
+    {
+        //    MIN_SAMPLES,  
+        for (size_t i = 1; i < CapacityAdvisor::MIN_SAMPLES; ++i) {
+            advisor.RecordFinalSize(batch, 300);
+            assert(advisor.Suggest(batch, sizeof(int)) == 0);
+        }
+        advisor.RecordFinalSize(batch, 300);
+        assert(advisor.Suggest(batch, sizeof(int)) == 300);
+        assert(advisor.Suggest(other, sizeof(int)) == 0);
+    }
+    {
+        // 90-    16  : 15-  
+        for (size_t size = 1; size <= CapacityAdvisor::WINDOW; ++size) {
+            advisor.RecordFinalSize(batch, size * 10);
+        }
+        assert(advisor.Suggest(batch, sizeof(int)) == 150);
+        //    
+        for (size_t i = 0; i < CapacityAdvisor::WINDOW; ++i) {
+            advisor.RecordFinalSize(batch, 20);
+        }
+        assert(advisor.Suggest(batch, sizeof(int)) == 20);
+    }
+    {
+        //    
+        for (size_t i = 0; i < CapacityAdvisor::WINDOW; ++i) {
+            advisor.RecordFinalSize(other, 1'000'000);
+        }
+        assert(advisor.Suggest(other, 1) == CapacityAdvisor::DEFAULT_MAX_HINT_BYTES);
+        assert(advisor.Suggest(other, 8) == CapacityAdvisor::DEFAULT_MAX_HINT_BYTES / 8);
+        advisor.SetMaxHintBytes(0);
+        assert(advisor.Suggest(other, 1) == 0);
+        advisor.SetMaxHintBytes(CapacityAdvisor::DEFAULT_MAX_HINT_BYTES);
+    }
+    {
+        //     :        
+        const char first_tag[] = "request";
+        const char second_tag[] = "request";
+        assert(static_cast<const void*>(first_tag) != static_cast<const void*>(second_tag));
+        for (size_t i = 0; i < CapacityAdvisor::MIN_SAMPLES; ++i) {
+            advisor.RecordFinalSize(CallSite{ first_tag }, 64);
+        }
+        assert(advisor.Suggest(CallSite{ first_tag }, sizeof(int)) == 64);
+        assert(advisor.Suggest(CallSite{ second_tag }, sizeof(int)) == 0);
+    }
+    advisor.Clear();
+    assert(advisor.Suggest(batch, sizeof(int)) == 0);
+}
+
+void Test15() {
+    {
+        //       -
+        BitVector bits;
+        for (size_t i = 0; i < 130; ++i) {
+            bits.PushBack(i % 3 == 0);
+        }
+        assert(bits.Size() == 130 && bits.Capacity() == 256);
+        assert(bits[0] && !bits[1] && bits[129]);
+        bits[1] = true;
+        bits[0] = bits[2];
+        bits[129].Flip();
+        assert(bits[1] && !bits[0] && !bits[129]);
+        bits.PopBack();
+        assert(bits.Size() == 129);
+        assert(bits.Count() == 43);
+    }
+    {
+        // Resize       
+        BitVector bits(70, true);
+        assert(bits.Count() == 70 && bits.WordsSize() == 2);
+        bits.Resize(65);
+        bits.Resize(200, false);
+        assert(bits.Count() == 65);
+        bits.Resize(10);
+        bits.Resize(64, true);
+        assert(bits.Count() == 64);
+        bits.FlipAll();
+        assert(bits.Count() == 0 && bits.FindFirst() == bits.Size());
+    }
+    {
+        //  ,      Vector<bool>
+        std::mt19937 generator(15);
+        const size_t size = 1000;
+        BitVector lhs(size);
+        BitVector rhs(size);
+        Vector<bool> expected_lhs(size);
+        Vector<bool> expected_rhs(size);
+        for (size_t i = 0; i < size; ++i) {
+            expected_lhs[i] = lhs[i] = generator() % 7 == 0;
+            expected_rhs[i] = rhs[i] = generator() % 5 == 0;
+        }
+        const BitVector both = lhs & rhs;
+        const BitVector any = lhs | rhs;
+        const BitVector one = lhs ^ rhs;
+        const BitVector inverted = ~lhs;
+        size_t count = 0;
+        for (size_t i = 0; i < size; ++i) {
+            assert(both[i] == (expected_lhs[i] && expected_rhs[i]));
+            assert(any[i] == (expected_lhs[i] || expected_rhs[i]));
+            assert(one[i] == (expected_lhs[i] != expected_rhs[i]));
+            assert(inverted[i] == !expected_lhs[i]);
+            count += expected_lhs[i];
+        }
+        assert(lhs.Count() == count && inverted.Count() == size - count);
+
+        size_t found = 0;
+        for (size_t i = lhs.FindFirst(); i < lhs.Size(); i = lhs.FindNext(i + 1)) {
+            assert(expected_lhs[i]);
+            ++found;
+        }
+        assert(found == count);
+    }
+    {
+        //      
+        BitVector bits(10'000);
+        bits[9'999] = true;
+        assert(bits.FindFirst() == 9'999);
+        assert(bits.FindNext(9'999) == 9'999);
+        assert(bits.FindNext(10'000) == bits.Size());
+
+        BitVector copy(bits);
+        assert(copy == bits);
+        copy[0] = true;
+        assert(copy != bits);
+        copy = bits;
+        assert(copy == bits);
+        BitVector moved(std::move(copy));
+        assert(moved == bits && copy.IsEmpty());
+    }
+}
+
+template <typename T>
+void CheckCompressedIntVector(const Vector<T>& expected, typename CompressedIntVector<T>::Encoding encoding) {
+    CompressedIntVector<T> compressed(encoding);
+    for (T value : expected) {
+        compressed.PushBack(value);
+    }
+    assert(compressed.Size() == expected.Size());
+    assert(compressed.BlockCount() == expected.Size() / CompressedIntVector<T>::BLOCK_SIZE);
+    for (size_t i = 0; i < expected.Size(); ++i) {
+        assert(compressed[i] == expected[i]);
+    }
+    size_t index = 0;
+    for (T value : compressed) {
+        assert(value == expected[index++]);
+    }
+    assert(index == expected.Size());
+    index = 0;
+    compressed.ForEach([&](T value) {
+        assert(value == expected[index++]);
+    });
+    assert(index == expected.Size());
+}
+
+template <typename T>
+void CheckCompressedIntVector(const Vector<T>& expected) {
+    CheckCompressedIntVector(expected, CompressedIntVector<T>::Encoding::FRAME_OF_REFERENCE);
+    CheckCompressedIntVector(expected, CompressedIntVector<T>::Encoding::DELTA);
+}
+
+void Test16() {
+    std::mt19937_64 generator(16);
+    {
+        //        
+        Vector<uint32_t> ids;
+        uint32_t id = 1'000'000;
+        for (size_t i = 0; i < 10'000; ++i) {
+            id += static_cast<uint32_t>(generator() % 16);
+            ids.PushBack(id);
+        }
+        CheckCompressedIntVector(ids);
+
+        using Encoding = CompressedIntVector<uint32_t>::Encoding;
+        CompressedIntVector<uint32_t> compressed;
+        CompressedIntVector<uint32_t> deltas(Encoding::DELTA);
+        assert(compressed.GetEncoding() == Encoding::FRAME_OF_REFERENCE && deltas.GetEncoding() == Encoding::DELTA);
+        for (uint32_t value : ids) {
+            compressed.PushBack(value);
+            deltas.PushBack(value);
+        }
+        assert(compressed.UncompressedBytes() == ids.Size() * sizeof(uint32_t));
+        assert(compressed.CompressionRatio() > 2.5);
+        //    ,     
+        assert(deltas.CompressionRatio() > 5.0);
+        compressed.Clear();
+        assert(compressed.IsEmpty() && compressed.begin() == compressed.end());
+    }
+    {
+        //  :      
+        static_assert(std::is_same_v<std::iterator_traits<CompressedIntVector<uint32_t>::const_iterator>::iterator_category,
+            std::forward_iterator_tag>);
+        CompressedIntVector<uint32_t> compressed;
+        for (uint32_t i = 0; i < 300; ++i) {
+            compressed.PushBack(i * 7);
+        }
+        auto it = compressed.begin();
+        const auto saved = it;
+        for (size_t i = 0; i < 200; ++i) {
+            assert(*it++ == i * 7);
+        }
+        assert(*it.operator->() == 200 * 7);
+        assert(std::distance(saved, compressed.end()) == 300);
+        assert(*saved == 0);
+        assert(std::max_element(compressed.begin(), compressed.end()) != compressed.end());
+        assert(*std::max_element(compressed.begin(), compressed.end()) == 299 * 7);
+        CompressedIntVector<uint32_t>::const_iterator empty;
+        assert(empty == CompressedIntVector<uint32_t>().end());
+    }
+    {
+        //   ,  0    
+        for (unsigned bits = 0; bits <= 64; ++bits) {
+            const uint64_t mask = bits == 64 ? ~uint64_t{ 0 } : (uint64_t{ 1 } << bits) - 1;
+            Vector<uint64_t> values;
+            Vector<uint32_t> narrow;
+            for (size_t i = 0; i < 300; ++i) {
+                values.PushBack(42 + (generator() & mask));
+                narrow.PushBack(static_cast<uint32_t>(7 + (generator() & mask)));
+            }
+            CheckCompressedIntVector(values);
+            CheckCompressedIntVector(narrow);
+        }
+    }
+    {
+        //      
+        Vector<uint32_t> values;
+        for (uint32_t i = 0; i < 5; ++i) {
+            values.PushBack(i * 3);
+        }
+        CheckCompressedIntVector(values);
+    }
+}
+
+template <typename T, typename Generate>
+void CheckRadixSort(size_t size, Generate generate) {
+    Vector<T> values;
+    for (size_t i = 0; i < size; ++i) {
+        values.PushBack(generate());
+    }
+    Vector<T> expected(values);
+    std::sort(expected.begin(), expected.end());
+    RadixSort(values);
+    assert(std::equal(values.begin(), values.end(), expected.begin(), expected.end()));
+}
+
+void Test17() {
+    std::mt19937_64 generator(17);
+    {
+        //      ,  
+        CheckRadixSort<uint32_t>(10'000, [&] { return static_cast<uint32_t>(generator()); });
+        CheckRadixSort<uint64_t>(1'000, [&] { return generator(); });
+        CheckRadixSort<int>(10'000, [&] { return static_cast<int>(generator()); });
+        CheckRadixSort<int16_t>(1'000, [&] { return static_cast<int16_t>(generator()); });
+        CheckRadixSort<float>(10'000, [&] { return static_cast<float>(static_cast<int32_t>(generator() % 2'000'001) - 1'000'000) / 7.0f; });
+        CheckRadixSort<double>(1'000, [&] { return static_cast<double>(static_cast<int64_t>(generator())) / 1e6; });
+        //   :    
+        CheckRadixSort<uint32_t>(1'000, [&] { return static_cast<uint32_t>(generator() % 200); });
+        CheckRadixSort<uint32_t>(1, [&] { return 5u; });
+        CheckRadixSort<uint32_t>(0, [&] { return 5u; });
+    }
+    {
+        //     ,    
+        using Record = std::pair<uint32_t, std::string>;
+        RawMemory<Record> scratch;
+        for (size_t round = 0; round < 2; ++round) {
+            Vector<Record> records;
+            for (size_t i = 0; i < 2'000; ++i) {
+                records.EmplaceBack(static_cast<uint32_t>(generator() % 50), std::to_string(i));
+            }
+            Vector<Record> expected(records);
+            std::stable_sort(expected.begin(), expected.end(), [](const Record& lhs, const Record& rhs) {
+                return lhs.first < rhs.first;
+            });
+            RadixSortBy(records, [](const Record& record) { return record.first; }, scratch);
+            assert(std::equal(records.begin(), records.end(), expected.begin(), expected.end()));
+            assert(scratch.Capacity() == 2'000);
+        }
+    }
+    {
+        //      ,      
+        for (size_t threads : { 1, 3, 4 }) {
+            Vector<uint64_t> values;
+            for (size_t i = 0; i < 100'000; ++i) {
+                values.PushBack(generator() % 1'000);
+            }
+            Vector<uint64_t> expected(values);
+            std::sort(expected.begin(), expected.end(), std::greater<>{});
+            ParallelSort(values, threads, std::greater<>{});
+            assert(std::equal(values.begin(), values.end(), expected.begin(), expected.end()));
+        }
+        Vector<int> empty;
+        ParallelSort(empty);
+        assert(empty.Size() == 0);
+    }
+    {
+        //      
+        Vector<int> values(100'000);
+        bool thrown = false;
+        try {
+            ParallelSort(values, 2, [](int, int) -> bool {
+                throw std::runtime_error("comparison failed");
+            });
+        }
+        catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown && values.Size() == 100'000);
+    }
+}
+
+//  ThrowingMoveObj   id = 1..size   
+Vector<ThrowingMoveObj> MakeFullVector(size_t size) {
+    Vector<ThrowingMoveObj> v;
+    v.Reserve(size);
+    for (size_t i = 1; i <= size; ++i) {
+        v.EmplaceBack(static_cast<int>(i));
+    }
+    return v;
+}
+
+void CheckUnchanged(const Vector<ThrowingMoveObj>& v, size_t size) {
+    assert(v.Size() == size && v.Capacity() == size);
+    for (size_t i = 0; i < size; ++i) {
+        assert(v[i].obj.id == static_cast<int>(i + 1));
+    }
+    assert(Obj::GetAliveObjectCount() == static_cast<int>(size));
+}
+
+void Test18() {
+    const size_t SIZE = 8;
+    {
+        //    ,      
+        for (size_t failing : { size_t{ 0 }, size_t{ 2 }, size_t{ 5 }, SIZE - 1 }) {
+            for (size_t pos : { size_t{ 0 }, size_t{ 3 }, SIZE }) {
+                Obj::ResetCounters();
+                {
+                    Vector<ThrowingMoveObj> v = MakeFullVector(SIZE);
+                    v[failing].obj.throw_on_copy = true;
+                    try {
+                        v.Emplace(v.begin() + pos, ID);
+                        assert(false);
+                    }
+                    catch (const std::runtime_error&) {
+                    }
+                    v[failing].obj.throw_on_copy = false;
+                    CheckUnchanged(v, SIZE);
+                }
+                assert(Obj::GetAliveObjectCount() == 0);
+            }
+        }
+    }
+    {
+        //     EmplaceBack, PushBack  Reserve
+        Obj::ResetCounters();
+        {
+            Vector<ThrowingMoveObj> v = MakeFullVector(SIZE);
+            v[4].obj.throw_on_copy = true;
+            try {
+                v.EmplaceBack(ID);
+                assert(false);
+            }
+            catch (const std::runtime_error&) {
+            }
+            try {
+                v.PushBack(ThrowingMoveObj(ID));
+                assert(false);
+            }
+            catch (const std::runtime_error&) {
+            }
+            try {
+                v.Reserve(SIZE * 4);
+                assert(false);
+            }
+            catch (const std::runtime_error&) {
+            }
+            v[4].obj.throw_on_copy = false;
+            CheckUnchanged(v, SIZE);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        //     :   ,  
+        Obj::ResetCounters();
+        {
+            Vector<Obj> v;
+            v.Reserve(SIZE);
+            for (size_t i = 0; i < SIZE; ++i) {
+                v.EmplaceBack(static_cast<int>(i));
+            }
+            const Obj* data = v.Data();
+            Obj::default_construction_throw_countdown = 1;
+            try {
+                v.Emplace(v.begin() + 3);
+                assert(false);
+            }
+            catch (const std::runtime_error&) {
+            }
+            assert(v.Size() == SIZE && v.Capacity() == SIZE && v.Data() == data);
+            assert(Obj::num_moved == 0 && Obj::num_copied == 0);
+            assert(Obj::GetAliveObjectCount() == static_cast<int>(SIZE));
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        //         
+        Obj::ResetCounters();
+        {
+            Vector<ThrowingMoveObj> v = MakeFullVector(SIZE);
+            v.Emplace(v.begin() + 3, ID);
+            assert(v.Size() == SIZE + 1 && v.Capacity() == SIZE * 2);
+            assert(v[3].obj.id == ID && v[2].obj.id == 3 && v[4].obj.id == 4);
+            assert(Obj::num_copied == static_cast<int>(SIZE) && Obj::num_moved == 0);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+
+        static_assert(std::is_trivially_copyable_v<Point>);
+        Vector<Point> points;
+        for (int i = 0; i < 5; ++i) {
+            points.Emplace(points.begin() + i / 2, Point{ i, i * 10 });
+        }
+        const Point expected[] = { { 1, 10 }, { 3, 30 }, { 4, 40 }, { 2, 20 }, { 0, 0 } };
+        assert(std::equal(points.begin(), points.end(), std::begin(expected), std::end(expected),
+            [](const Point& lhs, const Point& rhs) {
+                return lhs.x == rhs.x && lhs.y == rhs.y;
+            }));
+    }
+}
+
+void Test19() {
+    {
+        //           
+        int values[] = { 1, 2, 3 };
+        const IteratorGeneration generation = MakeIteratorGeneration();
+        CheckedIterator<int> it(values, generation);
+        CheckedIterator<const int> const_it = it + 1;
+        assert(*it == 1 && const_it[1] == 3 && *(2 + it) == 3);
+        assert(const_it - it == 1 && it < const_it && ++CheckedIterator<int>(it) == const_it);
+        //      
+        static_assert(!std::is_convertible_v<CheckedIterator<int>, int*>);
+        const int* raw = static_cast<const int*>(const_it);
+        assert(raw == values + 1);
+        assert(it.IsValid() && const_it.IsValid());
+        ++*generation;
+        assert(!it.IsValid() && !const_it.IsValid());
+        assert(CheckedIterator<int>().IsValid());
+    }
+    {
+        //  Vector    ,      
+        Vector<int> v;
+        v.Reserve(4);
+        for (int i = 0; i < 4; ++i) {
+            v.PushBack(i);
+        }
+        Vector<int>::iterator it = v.begin() + 1;
+        assert(&*it == v.Data() + 1 && *it == 1);
+#ifdef VECTOR_CHECKED_ITERATORS
+        v.PopBack();
+        v.PushBack(3);
+        assert(it.IsValid());
+        v.PushBack(4);
+        assert(!it.IsValid());
+        it = v.begin() + 1;
+        assert(it.IsValid() && *it == 1);
+        v.Reserve(v.Capacity() * 2);
+        assert(!it.IsValid());
+#endif
+    }
+#ifdef VECTOR_CHECKED_ITERATORS
+    {
+        //   :        
+        //        
+        Vector<int>::iterator it;
+        Vector<int>::iterator other_it;
+        {
+            Vector<int> v(4);
+            Vector<int> other(2);
+            it = v.begin() + 1;
+            other_it = other.begin();
+            v.Swap(other);
+            assert(it.IsValid() && other_it.IsValid());
+            assert(&*it == other.Data() + 1 && &*other_it == v.Data());
+            other.Reserve(other.Capacity() * 2);
+            assert(!it.IsValid() && other_it.IsValid());
+
+            Vector<int> moved(std::move(v));
+            assert(other_it.IsValid() && &*other_it == moved.Data());
+            v = std::move(moved);
+            assert(other_it.IsValid() && &*other_it == v.Data());
+            other = Vector<int>(8);
+        }
+        assert(!it.IsValid() && !other_it.IsValid());
+    }
+#endif
+    {
+        //  ASan  VECTOR_ANNOTATE_CONTAINER     Size()
+        const auto check_annotation = [](const Vector<int>& v) {
+#ifdef VECTOR_ASAN_ANNOTATIONS
+            for (size_t i = 0; i < v.Capacity(); ++i) {
+                assert((__asan_address_is_poisoned(v.Data() + i) != 0) == (i >= v.Size()));
+            }
+#else
+            (void)v;
+#endif
+        };
+        Vector<int> v;
+        v.Reserve(8);
+        check_annotation(v);
+        for (int i = 0; i < 3; ++i) {
+            v.PushBack(i * 10);
+            check_annotation(v);
+        }
+        v.Insert(v.begin() + 1, 5);
+        check_annotation(v);
+        v.Erase(v.begin());
+        check_annotation(v);
+        v.PopBack();
+        check_annotation(v);
+        v.Resize(7);
+        check_annotation(v);
+        v.Resize(2);
+        check_annotation(v);
+        const int sorted[] = { 1, 7, 12 };
+        v.InsertSorted(std::begin(sorted), std::end(sorted));
+        assert(v.Size() == 5 && v[0] == 1 && v[4] == 12);
+        check_annotation(v);
+
+        Vector<int> small(3);
+        v = small;
+        check_annotation(v);
+        Vector<int> large(6);
+        v = large;
+        check_annotation(v);
+        while (v.Size() < 9) {
+            v.EmplaceBack(1);
+        }
+        assert(v.Capacity() == 16);
+        check_annotation(v);
+        v.Clear();
+        check_annotation(v);
+        v = std::move(large);
+        check_annotation(v);
+    }
+}
+
+void Test20() {
+    {
+        //        ;   
+        const size_t sizes[] = { 20000, 0, 35000, 7 };
+        const size_t total = 20000 + 35000 + 7;
+        ParallelVectorBuilder<uint64_t> builder(std::size(sizes));
+        for (int round = 0; round < 2; ++round) {
+            Vector<std::thread> threads;
+            for (size_t i = 0; i < std::size(sizes); ++i) {
+                threads.EmplaceBack([&builder, &sizes, i] {
+                    for (size_t j = 0; j < sizes[i]; ++j) {
+                        builder.Chunk(i).PushBack(i * 1'000'000 + j);
+                    }
+                });
+            }
+            for (std::thread& thread : threads) {
+                thread.join();
+            }
+            assert(builder.Size() == total);
+            const Vector<uint64_t> result = builder.Finish(4);
+            assert(result.Size() == total && result.Capacity() == total);
+            size_t pos = 0;
+            for (size_t i = 0; i < std::size(sizes); ++i) {
+                for (size_t j = 0; j < sizes[i]; ++j) {
+                    assert(result[pos++] == i * 1'000'000 + j);
+                }
+                assert(builder.Chunk(i).Size() == 0 && builder.Chunk(i).Capacity() >= sizes[i]);
+            }
+        }
+        assert(builder.Finish().Size() == 0);
+    }
+    {
+        //   
+        ParallelVectorBuilder<std::string> builder(3);
+        for (size_t i = 0; i < 3 * 20000; ++i) {
+            builder.Chunk(i % 3).PushBack(std::to_string(i));
+        }
+        const Vector<std::string> result = builder.Finish(3);
+        assert(result.Size() == 3 * 20000);
+        for (size_t i = 0; i < result.Size(); ++i) {
+            assert(result[i] == std::to_string(i % 20000 * 3 + i / 20000));
+        }
+    }
+    {
+        //   :   ,   
+        Obj::ResetCounters();
+        {
+            ParallelVectorBuilder<ThrowingMoveObj> builder(3);
+            for (int i = 0; i < 7; ++i) {
+                builder.Chunk(i % 3).EmplaceBack(i);
+            }
+            builder.Chunk(1)[1].obj.throw_on_copy = true;
+            try {
+                builder.Finish(1);
+                assert(false);
+            }
+            catch (const std::runtime_error&) {
+            }
+            assert(builder.Size() == 7 && Obj::GetAliveObjectCount() == 7);
+            builder.Chunk(1)[1].obj.throw_on_copy = false;
+            const Vector<ThrowingMoveObj> result = builder.Finish(1);
+            const int expected[] = { 0, 3, 6, 1, 4, 2, 5 };
+            for (size_t i = 0; i < result.Size(); ++i) {
+                assert(result[i].obj.id == expected[i]);
+            }
+            assert(result.Size() == 7 && Obj::GetAliveObjectCount() == 7);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        //     : Finish    ,  
+        //      
+        constexpr size_t CHUNKS = 4;
+        constexpr size_t CHUNK_SIZE = 20000;
+        {
+            ParallelVectorBuilder<ThrowingCopyObj> builder(CHUNKS);
+            for (size_t i = 0; i < CHUNKS * CHUNK_SIZE; ++i) {
+                builder.Chunk(i / CHUNK_SIZE).EmplaceBack(static_cast<int>(i));
+            }
+            //  CHUNKS * MIN_SPAN :  CHUNKS ,    
+            builder.Chunk(1)[CHUNK_SIZE / 2].throw_on_copy = true;
+            builder.Chunk(3)[CHUNK_SIZE - 1].throw_on_copy = true;
+            const int alive = ThrowingCopyObj::num_alive;
+            try {
+                builder.Finish(CHUNKS);
+                assert(false);
+            }
+            catch (const std::runtime_error&) {
+            }
+            assert(builder.Size() == CHUNKS * CHUNK_SIZE && ThrowingCopyObj::num_alive == alive);
+            builder.Chunk(1)[CHUNK_SIZE / 2].throw_on_copy = false;
+            builder.Chunk(3)[CHUNK_SIZE - 1].throw_on_copy = false;
+            const Vector<ThrowingCopyObj> result = builder.Finish(CHUNKS);
+            assert(result.Size() == CHUNKS * CHUNK_SIZE);
+            for (size_t i = 0; i < result.Size(); ++i) {
+                assert(result[i].id == static_cast<int>(i));
+            }
+            assert(builder.Size() == 0 && ThrowingCopyObj::num_alive == alive);
+        }
+        assert(ThrowingCopyObj::num_alive == 0);
+    }
+}
+
 int main() {
     try {
         Test1();
@@ -392,6 +2198,21 @@ int main() {
         Test3();
         Test4();
         Test5();
+        Test6();
+        Test7();
+        Test8();
+        Test9();
+        Test10();
+        Test11();
+        Test12();
+        Test13();
+        Test14();
+        Test15();
+        Test16();
+        Test17();
+        Test18();
+        Test19();
+        Test20();
     }
     catch (const std::exception& e) {
         std::cerr << e.what() << std::endl;
@@ -0,0 +1,106 @@
+#pragma once
+#include "vector.h"
+#include "vector_sort.h"
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+
+// Собирает Vector из частей, которые параллельно заполняют несколько потоков: поток i
+// добавляет элементы только в Chunk(i). Finish() считает смещения частей, один раз выделяет
+// память под результат и переносит части на свои места в нескольких потоках — побайтно
+// для тривиально копируемых типов, перемещением или копированием для остальных по тем же
+// правилам, что и реаллокация Vector. Порядок элементов — порядок частей
+template <typename T>
+class ParallelVectorBuilder {
+public:
+    explicit ParallelVectorBuilder(size_t chunk_count)
+        : chunks_(chunk_count) {
+    }
+
+    size_t ChunkCount() const noexcept {
+        return chunks_.Size();
+    }
+
+    // Часть с номером index; разные части можно заполнять одновременно из разных потоков
+    Vector<T>& Chunk(size_t index) noexcept {
+        return chunks_[index].values;
+    }
+
+    const Vector<T>& Chunk(size_t index) const noexcept {
+        return chunks_[index].values;
+    }
+
+    // Суммарный размер частей
+    size_t Size() const noexcept {
+        size_t size = 0;
+        for (const PaddedChunk& chunk : chunks_) {
+            size += chunk.values.Size();
+        }
+        return size;
+    }
+
+    // Склеивает части в один вектор, используя до threads потоков, и очищает части, сохраняя
+    // их вместимость для следующего раунда. Пока части заполняются, вызывать нельзя.
+    // Если копирование элемента бросает исключение, части остаются нетронутыми
+    Vector<T> Finish(size_t threads = std::thread::hardware_concurrency()) {
+        constexpr size_t MIN_SPAN = size_t{ 1 } << 14;
+        const size_t chunk_count = chunks_.Size();
+        // Часть i займёт в результате [offsets[i], offsets[i + 1])
+        Vector<size_t> offsets(chunk_count + 1);
+        for (size_t i = 0; i < chunk_count; ++i) {
+            offsets[i + 1] = offsets[i] + chunks_[i].values.Size();
+        }
+        const size_t total = offsets[chunk_count];
+        threads = std::max<size_t>(std::min(threads, total / MIN_SPAN), 1);
+
+        // Поток w переносит элементы результата [total * w / threads, total * (w + 1) / threads)
+        // независимо от того, на какие части приходится этот отрезок
+        RawMemory<T> memory(total);
+        Vector<size_t> relocated(threads);
+        const auto relocate_span = [&](size_t worker) {
+            const size_t first = total * worker / threads;
+            const size_t last = total * (worker + 1) / threads;
+            size_t chunk = std::upper_bound(offsets.Data(), offsets.Data() + chunk_count, first) - offsets.Data() - 1;
+            for (size_t pos = first; pos < last; ++chunk) {
+                const size_t count = std::min(last, offsets[chunk + 1]) - pos;
+                Vector<T>::RelocateN(chunks_[chunk].values.Data() + (pos - offsets[chunk]), count, memory + pos);
+                pos += count;
+                relocated[worker] = pos - first;
+            }
+        };
+        try {
+            if (threads == 1) {
+                relocate_span(0);
+            }
+            else {
+                vector_sort_detail::RunParallel(threads, relocate_span);
+            }
+        }
+        catch (...) {
+            // RelocateN сам разрушает недоделанный отрезок, остаются целиком перенесённые
+            for (size_t worker = 0; worker < threads; ++worker) {
+                std::destroy_n(memory + total * worker / threads, relocated[worker]);
+            }
+            throw;
+        }
+
+        for (PaddedChunk& chunk : chunks_) {
+            chunk.values.Clear();
+        }
+        Vector<T> result;
+        result.data_ = std::move(memory);
+        result.size_ = total;
+        return result;
+    }
+
+private:
+    // Между полями соседних частей не меньше 64 байт, поэтому они не попадают в одну кеш-линию
+    // и потоки, дописывающие в соседние части, не мешают друг другу
+    struct PaddedChunk {
+        Vector<T> values;
+        unsigned char padding[64];
+    };
+
+    Vector<PaddedChunk> chunks_;
+};
@@ -0,0 +1,242 @@
+#pragma once
+#include "call_site.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Профилировщик реаллокаций Vector по местам вызова. Каждый поток пишет в собственную
+// таблицу фиксированного размера без блокировок; мьютекс берётся только при создании
+// и завершении потока и при построении отчёта.
+// Vector сообщает о событиях, если определён макрос VECTOR_PROFILE_REALLOCATIONS
+class ReallocationProfiler {
+public:
+    // Сводная статистика по одному месту вызова
+    struct SiteStats {
+        CallSite site;
+        size_t growths = 0;         // реаллокации векторов, созданных в этом месте
+        size_t bytes_moved = 0;     // байт перенесено при этих реаллокациях
+        size_t reserves = 0;        // вызовы Reserve из этого места
+        size_t vectors = 0;         // разрушено векторов, созданных в этом месте
+        size_t max_final_size = 0;  // наибольший размер вектора к моменту разрушения
+
+        // Рекомендуемый аргумент Reserve в месте создания вектора
+        size_t SuggestedReserve() const noexcept {
+            return max_final_size;
+        }
+    };
+
+    ReallocationProfiler(const ReallocationProfiler&) = delete;
+    ReallocationProfiler& operator=(const ReallocationProfiler&) = delete;
+
+    // Таблица текущего потока либо nullptr, если поток уже завершается
+    static ReallocationProfiler* Local() noexcept {
+        if (LocalDestroyed()) {
+            return nullptr;
+        }
+        thread_local ReallocationProfiler profiler;
+        return &profiler;
+    }
+
+    void RecordGrowth(const CallSite& origin, size_t bytes_moved) noexcept {
+        if (Entry* entry = FindOrInsert(origin)) {
+            Increment(entry->growths, 1);
+            Increment(entry->bytes_moved, bytes_moved);
+        }
+    }
+
+    void RecordReserve(const CallSite& site) noexcept {
+        if (Entry* entry = FindOrInsert(site)) {
+            Increment(entry->reserves, 1);
+        }
+    }
+
+    void RecordFinalSize(const CallSite& origin, size_t size) noexcept {
+        if (Entry* entry = FindOrInsert(origin)) {
+            Increment(entry->vectors, 1);
+            if (size > entry->max_final_size.load(std::memory_order_relaxed)) {
+                entry->max_final_size.store(size, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Статистика всех потоков, отсортированная по убыванию числа реаллокаций
+    static std::vector<SiteStats> Collect() {
+        Registry& registry = GetRegistry();
+        std::lock_guard guard(registry.mutex);
+        std::vector<SiteStats> result = registry.finished;
+        for (const ReallocationProfiler* profiler : registry.live) {
+            profiler->AppendTo(result);
+        }
+        return MergeBySite(std::move(result));
+    }
+
+    static void PrintReport(std::ostream& out) {
+        const std::vector<SiteStats> stats = Collect();
+        out << "Vector reallocation profile (" << stats.size() << " call sites)" << std::endl;
+        for (const SiteStats& site : stats) {
+            out << site.site.file << ':' << site.site.line << " (" << site.site.function << "): "
+                << site.growths << " reallocations, " << site.bytes_moved << " bytes moved, "
+                << site.reserves << " Reserve calls, " << site.vectors << " vectors, max final size "
+                << site.max_final_size;
+            if (site.growths > 0) {
+                out << ", suggest Reserve(" << site.SuggestedReserve() << ')';
+            }
+            out << std::endl;
+        }
+        const size_t dropped = GetRegistry().dropped.load(std::memory_order_relaxed);
+        if (dropped > 0) {
+            out << dropped << " events dropped: per-thread table is full" << std::endl;
+        }
+    }
+
+    // Печатает отчёт в std::cerr при завершении программы
+    static void ReportAtExit() {
+        static std::once_flag once;
+        std::call_once(once, [] {
+            std::atexit([] {
+                PrintReport(std::cerr);
+            });
+        });
+    }
+
+    // Очищает статистику всех потоков
+    static void Reset() noexcept {
+        Registry& registry = GetRegistry();
+        std::lock_guard guard(registry.mutex);
+        registry.finished.clear();
+        registry.dropped.store(0, std::memory_order_relaxed);
+        for (ReallocationProfiler* profiler : registry.live) {
+            for (Entry& entry : profiler->entries_) {
+                entry.growths.store(0, std::memory_order_relaxed);
+                entry.bytes_moved.store(0, std::memory_order_relaxed);
+                entry.reserves.store(0, std::memory_order_relaxed);
+                entry.vectors.store(0, std::memory_order_relaxed);
+                entry.max_final_size.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    static constexpr size_t TABLE_SIZE = 1024;
+
+    // Счётчики меняет только поток-владелец, а читать их может поток, строящий отчёт
+    struct Entry {
+        std::atomic<const char*> file{ nullptr };
+        const char* function = nullptr;
+        unsigned line = 0;
+        std::atomic<size_t> growths{ 0 };
+        std::atomic<size_t> bytes_moved{ 0 };
+        std::atomic<size_t> reserves{ 0 };
+        std::atomic<size_t> vectors{ 0 };
+        std::atomic<size_t> max_final_size{ 0 };
+    };
+
+    struct Registry {
+        std::mutex mutex;
+        std::vector<ReallocationProfiler*> live;
+        std::vector<SiteStats> finished;
+        std::atomic<size_t> dropped{ 0 };
+    };
+
+    ReallocationProfiler() {
+        Registry& registry = GetRegistry();
+        std::lock_guard guard(registry.mutex);
+        registry.live.push_back(this);
+    }
+
+    ~ReallocationProfiler() {
+        Registry& registry = GetRegistry();
+        std::lock_guard guard(registry.mutex);
+        AppendTo(registry.finished);
+        registry.live.erase(std::find(registry.live.begin(), registry.live.end(), this));
+        LocalDestroyed() = true;
+    }
+
+    static bool& LocalDestroyed() noexcept {
+        thread_local bool destroyed = false;
+        return destroyed;
+    }
+
+    static Registry& GetRegistry() noexcept {
+        // Реестр не разрушается, чтобы им могли пользоваться деструкторы thread_local и atexit
+        static Registry* registry = new Registry;
+        return *registry;
+    }
+
+    static void Increment(std::atomic<size_t>& counter, size_t delta) noexcept {
+        counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+    }
+
+    Entry* FindOrInsert(const CallSite& site) noexcept {
+        const size_t hash = std::hash<const void*>{}(site.file) ^ (static_cast<size_t>(site.line) * 0x9E3779B97F4A7C15ull);
+        for (size_t probe = 0; probe < TABLE_SIZE; ++probe) {
+            Entry& entry = entries_[(hash + probe) % TABLE_SIZE];
+            const char* file = entry.file.load(std::memory_order_relaxed);
+            if (file == nullptr) {
+                entry.function = site.function;
+                entry.line = site.line;
+                entry.file.store(site.file, std::memory_order_release);
+                return &entry;
+            }
+            if (file == site.file && entry.line == site.line) {
+                return &entry;
+            }
+        }
+        GetRegistry().dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    void AppendTo(std::vector<SiteStats>& out) const {
+        for (const Entry& entry : entries_) {
+            const char* file = entry.file.load(std::memory_order_acquire);
+            if (file == nullptr) {
+                continue;
+            }
+            SiteStats stats;
+            stats.site = { file, entry.function, entry.line };
+            stats.growths = entry.growths.load(std::memory_order_relaxed);
+            stats.bytes_moved = entry.bytes_moved.load(std::memory_order_relaxed);
+            stats.reserves = entry.reserves.load(std::memory_order_relaxed);
+            stats.vectors = entry.vectors.load(std::memory_order_relaxed);
+            stats.max_final_size = entry.max_final_size.load(std::memory_order_relaxed);
+            out.push_back(stats);
+        }
+    }
+
+    // Одно и то же место могло попасть в таблицы нескольких потоков
+    static std::vector<SiteStats> MergeBySite(std::vector<SiteStats> stats) {
+        std::map<std::tuple<std::string, unsigned>, SiteStats> merged;
+        for (const SiteStats& item : stats) {
+            auto [it, inserted] = merged.emplace(std::make_tuple(std::string(item.site.file), item.site.line), item);
+            if (!inserted) {
+                SiteStats& total = it->second;
+                total.growths += item.growths;
+                total.bytes_moved += item.bytes_moved;
+                total.reserves += item.reserves;
+                total.vectors += item.vectors;
+                total.max_final_size = std::max(total.max_final_size, item.max_final_size);
+            }
+        }
+        std::vector<SiteStats> result;
+        for (auto& [key, item] : merged) {
+            if (item.growths + item.reserves + item.vectors > 0) {
+                result.push_back(item);
+            }
+        }
+        std::stable_sort(result.begin(), result.end(), [](const SiteStats& lhs, const SiteStats& rhs) {
+            return lhs.growths > rhs.growths;
+        });
+        return result;
+    }
+
+    Entry entries_[TABLE_SIZE];
+};
@@ -0,0 +1,314 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace static_vector_detail {
+
+    // Тривиально копируемые типы хранятся в объединении с массивом: такое хранилище побайтно
+    // копируется, не инициализирует ячейки при создании и пригодно для вычислений во время
+    // компиляции
+    template <typename T, size_t N>
+    struct TrivialStorage {
+        union Cells {
+#if __cplusplus >= 202002L
+            constexpr Cells() noexcept {
+            }
+#else
+            // До C++20 constexpr-конструктор объединения обязан инициализировать один из членов.
+            // GCC при этом обнуляет всё объединение, как и в std::optional
+            constexpr Cells() noexcept
+                : unused() {
+            }
+#endif
+            constexpr explicit Cells(std::in_place_t) noexcept
+                : elements() {
+            }
+
+            unsigned char unused;
+            T elements[N];
+        };
+
+        constexpr T* Data() noexcept {
+            return cells_.elements;
+        }
+        constexpr const T* Data() const noexcept {
+            return cells_.elements;
+        }
+
+        constexpr void Store(size_t index, const T& value) noexcept {
+#if __cplusplus < 202002L
+            // До C++20 вычисление во время компиляции не может сделать массив активным членом
+            // объединения присваиванием элементу, поэтому первая запись активирует его целиком
+            if constexpr (std::is_default_constructible_v<T>) {
+                if (__builtin_is_constant_evaluated() && index == 0) {
+                    cells_ = Cells(std::in_place);
+                }
+            }
+#endif
+            cells_.elements[index] = value;
+        }
+
+        Cells cells_;
+        size_t size_ = 0;
+    };
+
+    // Остальные типы живут в выровненном сыром буфере и копируются поэлементно
+    template <typename T, size_t N>
+    struct RawStorage {
+        RawStorage() = default;
+
+        RawStorage(const RawStorage& other) {
+            std::uninitialized_copy_n(other.Data(), other.size_, Data());
+            size_ = other.size_;
+        }
+
+        RawStorage(RawStorage&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+            std::uninitialized_move_n(other.Data(), other.size_, Data());
+            size_ = other.size_;
+        }
+
+        RawStorage& operator=(const RawStorage& rhs) {
+            if (this != &rhs) {
+                Assign(rhs.Data(), rhs.size_);
+            }
+            return *this;
+        }
+
+        RawStorage& operator=(RawStorage&& rhs) noexcept(std::is_nothrow_move_assignable_v<T>
+            && std::is_nothrow_move_constructible_v<T>) {
+            if (this != &rhs) {
+                Assign(std::make_move_iterator(rhs.Data()), rhs.size_);
+            }
+            return *this;
+        }
+
+        ~RawStorage() {
+            std::destroy_n(Data(), size_);
+        }
+
+        T* Data() noexcept {
+            return std::launder(reinterpret_cast<T*>(buffer_));
+        }
+        const T* Data() const noexcept {
+            return std::launder(reinterpret_cast<const T*>(buffer_));
+        }
+
+        // Присваивает общую часть, а недостающие элементы досоздаёт или лишние разрушает
+        template <typename InputIt>
+        void Assign(InputIt first, size_t count) {
+            const size_t common = std::min(size_, count);
+            for (size_t i = 0; i < common; ++i, ++first) {
+                Data()[i] = *first;
+            }
+            if (count > size_) {
+                std::uninitialized_copy_n(first, count - size_, Data() + size_);
+            }
+            else {
+                std::destroy_n(Data() + count, size_ - count);
+            }
+            size_ = count;
+        }
+
+        alignas(T) unsigned char buffer_[sizeof(T) * N];
+        size_t size_ = 0;
+    };
+
+    template <typename T>
+    inline constexpr bool IS_TRIVIAL_STORAGE = std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>;
+
+    template <typename T, size_t N>
+    using Storage = std::conditional_t<IS_TRIVIAL_STORAGE<T>, TrivialStorage<T, N>, RawStorage<T, N>>;
+
+}  // namespace static_vector_detail
+
+// Вектор фиксированной вместимости N со встроенным хранилищем: никогда не обращается к куче.
+// Переполнение в PushBack/EmplaceBack/Emplace/Resize проверяется только assert: в сборке
+// с NDEBUG оно приводит к неопределённому поведению. Если размер заранее не ограничен,
+// используйте методы Try*, которые при переполнении возвращают false.
+// Для тривиально копируемых T вектор побайтно копируется и может использоваться
+// в constexpr-вычислениях
+template <typename T, size_t N>
+class StaticVector : private static_vector_detail::Storage<T, N> {
+    static_assert(N > 0, "StaticVector capacity must be positive");
+
+public:
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    constexpr StaticVector() = default;
+
+    constexpr iterator begin() noexcept {
+        return this->Data();
+    }
+    constexpr iterator end() noexcept {
+        return this->Data() + this->size_;
+    }
+    constexpr const_iterator begin() const noexcept {
+        return this->Data();
+    }
+    constexpr const_iterator end() const noexcept {
+        return this->Data() + this->size_;
+    }
+    constexpr const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    constexpr const_iterator cend() const noexcept {
+        return end();
+    }
+
+    constexpr size_t Size() const noexcept {
+        return this->size_;
+    }
+
+    static constexpr size_t Capacity() noexcept {
+        return N;
+    }
+
+    constexpr bool IsEmpty() const noexcept {
+        return this->size_ == 0;
+    }
+
+    constexpr bool IsFull() const noexcept {
+        return this->size_ == N;
+    }
+
+    constexpr const T& operator[](size_t index) const noexcept {
+        assert(index < this->size_);
+        return this->Data()[index];
+    }
+
+    constexpr T& operator[](size_t index) noexcept {
+        assert(index < this->size_);
+        return this->Data()[index];
+    }
+
+    template <typename... Args>
+    constexpr T& EmplaceBack(Args&&... args) {
+        assert(!IsFull());
+        ConstructAt(this->size_, std::forward<Args>(args)...);
+        ++this->size_;
+        return this->Data()[this->size_ - 1];
+    }
+
+    template <typename S>
+    constexpr void PushBack(S&& value) {
+        EmplaceBack(std::forward<S>(value));
+    }
+
+    // Возвращает false и не меняет вектор, если он заполнен
+    template <typename... Args>
+    constexpr bool TryEmplaceBack(Args&&... args) {
+        if (IsFull()) {
+            return false;
+        }
+        EmplaceBack(std::forward<Args>(args)...);
+        return true;
+    }
+
+    template <typename S>
+    constexpr bool TryPushBack(S&& value) {
+        return TryEmplaceBack(std::forward<S>(value));
+    }
+
+    constexpr void PopBack() noexcept {
+        assert(!IsEmpty());
+        --this->size_;
+        DestroyAt(this->size_);
+    }
+
+    template <typename... Args>
+    constexpr iterator Emplace(const_iterator pos, Args&&... args) {
+        assert(begin() <= pos && pos <= end());
+        assert(!IsFull());
+        const size_t index = static_cast<size_t>(pos - cbegin());
+        if (index == this->size_) {
+            EmplaceBack(std::forward<Args>(args)...);
+            return begin() + index;
+        }
+        // Временный объект нужен, так как аргументы могут ссылаться на сдвигаемые элементы
+        T temp(std::forward<Args>(args)...);
+        T* data = this->Data();
+        ConstructAt(this->size_, std::move(data[this->size_ - 1]));
+        ++this->size_;
+        for (size_t i = this->size_ - 2; i > index; --i) {
+            data[i] = std::move(data[i - 1]);
+        }
+        data[index] = std::move(temp);
+        return begin() + index;
+    }
+
+    template <typename... Args>
+    constexpr bool TryEmplace(const_iterator pos, Args&&... args) {
+        if (IsFull()) {
+            return false;
+        }
+        Emplace(pos, std::forward<Args>(args)...);
+        return true;
+    }
+
+    constexpr iterator Insert(const_iterator pos, const T& value) {
+        return Emplace(pos, value);
+    }
+
+    constexpr iterator Insert(const_iterator pos, T&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    constexpr iterator Erase(const_iterator pos) {
+        assert(begin() <= pos && pos < end());
+        const size_t index = static_cast<size_t>(pos - cbegin());
+        T* data = this->Data();
+        for (size_t i = index; i + 1 < this->size_; ++i) {
+            data[i] = std::move(data[i + 1]);
+        }
+        PopBack();
+        return begin() + index;
+    }
+
+    constexpr void Resize(size_t new_size) {
+        assert(new_size <= N);
+        while (this->size_ > new_size) {
+            PopBack();
+        }
+        while (this->size_ < new_size) {
+            EmplaceBack();
+        }
+    }
+
+    constexpr bool TryResize(size_t new_size) {
+        if (new_size > N) {
+            return false;
+        }
+        Resize(new_size);
+        return true;
+    }
+
+    constexpr void Clear() noexcept {
+        while (this->size_ > 0) {
+            PopBack();
+        }
+    }
+
+private:
+    template <typename... Args>
+    constexpr void ConstructAt(size_t index, Args&&... args) {
+        if constexpr (static_vector_detail::IS_TRIVIAL_STORAGE<T>) {
+            this->Store(index, T(std::forward<Args>(args)...));
+        }
+        else {
+            new (this->Data() + index) T(std::forward<Args>(args)...);
+        }
+    }
+
+    constexpr void DestroyAt([[maybe_unused]] size_t index) noexcept {
+        if constexpr (!static_vector_detail::IS_TRIVIAL_STORAGE<T>) {
+            std::destroy_at(this->Data() + index);
+        }
+    }
+};
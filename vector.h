@@ -1,10 +1,50 @@
 #pragma once
 #include <cassert>
 #include <cstdlib>
+#include <cstring>
 #include <new>
 #include <utility>
 #include <memory>
 #include <algorithm>
+#include <functional>
+#include <iterator>
+
+#ifdef VECTOR_BUFFER_CACHE
+#include "buffer_cache.h"
+#endif
+
+#ifdef VECTOR_PROFILE_REALLOCATIONS
+#include "reallocation_profiler.h"
+#endif
+
+#ifdef VECTOR_ADAPTIVE_CAPACITY
+#include "capacity_advisor.h"
+#endif
+
+//     ,       
+#if defined(VECTOR_PROFILE_REALLOCATIONS) || defined(VECTOR_ADAPTIVE_CAPACITY)
+#define VECTOR_TRACK_ORIGIN
+#endif
+
+//     AddressSanitizer:  
+// VECTOR_ANNOTATE_CONTAINER       -fsanitize=address
+#ifdef VECTOR_ANNOTATE_CONTAINER
+#if defined(__SANITIZE_ADDRESS__)
+#define VECTOR_ASAN_ANNOTATIONS
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define VECTOR_ASAN_ANNOTATIONS
+#endif
+#endif
+#endif
+
+#ifdef VECTOR_ASAN_ANNOTATIONS
+#include <sanitizer/common_interface_defs.h>
+#endif
+
+#ifdef VECTOR_CHECKED_ITERATORS
+#include "checked_iterator.h"
+#endif
 
 template <typename T>
 class RawMemory {
@@ -12,12 +52,23 @@ public:
     RawMemory() = default;
 
     explicit RawMemory(size_t capacity)
+#ifdef VECTOR_CHECKED_ITERATORS
+        : generation_(capacity == 0 ? nullptr : MakeIteratorGeneration())
+        , buffer_(Allocate(capacity))
+#else
         : buffer_(Allocate(capacity))
+#endif
         , capacity_(capacity) {
     }
 
     ~RawMemory() {
-        Deallocate(buffer_);
+#ifdef VECTOR_CHECKED_ITERATORS
+        //      
+        if (generation_ != nullptr) {
+            ++*generation_;
+        }
+#endif
+        Deallocate(buffer_, capacity_);
     }
 
     T* operator+(size_t offset) noexcept {
@@ -43,12 +94,14 @@ public:
     RawMemory(const RawMemory&) = delete;
     RawMemory& operator=(const RawMemory& rhs) = delete;
     RawMemory(RawMemory&& other) noexcept
-        : buffer_(Allocate(other.capacity_))
-        , capacity_(other.capacity_)
-
+#ifdef VECTOR_CHECKED_ITERATORS
+        : generation_(std::move(other.generation_))
+        , buffer_(std::exchange(other.buffer_, nullptr))
+#else
+        : buffer_(std::exchange(other.buffer_, nullptr))
+#endif
+        , capacity_(std::exchange(other.capacity_, 0))
     {
-        buffer_ = nullptr;
-        std::swap(buffer_, other.buffer_);
     }
 
     RawMemory& operator=(RawMemory&& rhs) noexcept
@@ -59,6 +112,9 @@ public:
     }
 
     void Swap(RawMemory& other) noexcept {
+#ifdef VECTOR_CHECKED_ITERATORS
+        generation_.swap(other.generation_);
+#endif
         std::swap(buffer_, other.buffer_);
         std::swap(capacity_, other.capacity_);
     }
@@ -75,17 +131,37 @@ public:
         return capacity_;
     }
 
+#ifdef VECTOR_CHECKED_ITERATORS
+    //              
+    // ;     
+    const IteratorGeneration& Generation() const noexcept {
+        return generation_;
+    }
+#endif
+
 private:
     //     n      
     static T* Allocate(size_t n) {
+#ifdef VECTOR_BUFFER_CACHE
+        return n != 0 ? static_cast<T*>(BufferCache::AllocateBuffer(n * sizeof(T))) : nullptr;
+#else
         return n != 0 ? static_cast<T*>(operator new(n * sizeof(T))) : nullptr;
+#endif
     }
 
-    //   ,     buf   Allocate
-    static void Deallocate(T* buf) noexcept {
+    //     n ,     buf   Allocate
+    static void Deallocate(T* buf, [[maybe_unused]] size_t n) noexcept {
+#ifdef VECTOR_BUFFER_CACHE
+        BufferCache::DeallocateBuffer(buf, n * sizeof(T));
+#else
         operator delete(buf);
+#endif
     }
 
+#ifdef VECTOR_CHECKED_ITERATORS
+    //   buffer_:     ,  
+    IteratorGeneration generation_;
+#endif
     T* buffer_ = nullptr;
     size_t capacity_ = 0;
 };
@@ -107,49 +183,102 @@ template <typename T>
 class Vector {
 public:
 
+#ifdef VECTOR_TRACK_ORIGIN
+private:
+    //  ,    .    
+    //   CallSite  Vector
+    struct DefaultOrigin {
+        static DefaultOrigin Current(CallSite site = CallSite::Current()) noexcept {
+            return { site };
+        }
+
+        CallSite site;
+    };
+
+public:
+    Vector(DefaultOrigin origin = DefaultOrigin::Current()) noexcept
+        : origin_(origin.site) {
+    }
+
+    //   :       ,
+    //      
+    explicit Vector(CallSite origin) noexcept
+        : origin_(origin) {
+    }
+#else
     Vector() = default;
+#endif
 
+#ifdef VECTOR_CHECKED_ITERATORS
+    using iterator = CheckedIterator<T>;
+    using const_iterator = CheckedIterator<const T>;
+#else
     using iterator = T*;
     using const_iterator = const T*;
+#endif
 
     iterator begin() noexcept {
-        return data_.GetAddress();
+        return MakeIterator(data_.GetAddress());
     }
     iterator end() noexcept {
-        return data_.GetAddress() + size_;
+        return MakeIterator(data_.GetAddress() + size_);
     }
     const_iterator begin() const noexcept {
-        return data_.GetAddress();
+        return MakeIterator(data_.GetAddress());
     }
     const_iterator end() const noexcept {
-        return data_.GetAddress() + size_;
+        return MakeIterator(data_.GetAddress() + size_);
     }
     const_iterator cbegin() const noexcept {
-        return data_.GetAddress();
+        return MakeIterator(data_.GetAddress());
     }
     const_iterator cend() const noexcept {
-        return data_.GetAddress() + size_;
+        return MakeIterator(data_.GetAddress() + size_);
+    }
+
+    //   ;    begin()   
+    T* Data() noexcept {
+        return data_.GetAddress();
+    }
+    const T* Data() const noexcept {
+        return data_.GetAddress();
     }
 
 
+#ifdef VECTOR_TRACK_ORIGIN
+    explicit Vector(size_t size, CallSite origin = CallSite::Current())
+        : data_(size)
+        , size_(size)
+        , origin_(origin)
+#else
     explicit Vector(size_t size)
         : data_(size)
         , size_(size)  //
+#endif
     {
         std::uninitialized_value_construct_n(data_.GetAddress(), size);
     }
 
+#ifdef VECTOR_TRACK_ORIGIN
+    Vector(const Vector& other, CallSite origin = CallSite::Current())
+        : data_(other.size_)
+        , size_(other.size_)
+        , origin_(origin)
+#else
     Vector(const Vector& other)
         : data_(other.size_)
         , size_(other.size_)
+#endif
     {
         std::uninitialized_copy_n(other.data_.GetAddress(), size_, data_.GetAddress());
     }
 
     Vector(Vector&& other) noexcept
         : data_(std::move(other.data_))
-        , size_(other.size_)
-
+        , size_(std::exchange(other.size_, 0))
+#ifdef VECTOR_TRACK_ORIGIN
+        , origin_(other.origin_)
+#endif
     {
     }
 
@@ -160,18 +289,27 @@ public:
                 std::copy(rhs.data_.GetAddress(), rhs.data_.GetAddress() + rhs.size_, data_.GetAddress());
                 //copy_n(rhs.data_.GetAddress(), rhs.Size(), data_.GetAddress());
                 std::destroy_n(data_.GetAddress() + rhs.size_, delta);
+                Annotate(size_, rhs.size_);
                 size_ = rhs.size_;
             }
             else {
                 if (data_.Capacity() < rhs.size_) {
-                    Vector rhs_copy(rhs);
-                    Swap(rhs_copy);
+                    //       ,  
+                    //        
+                    RawMemory<T> new_data(rhs.size_);
+                    std::uninitialized_copy_n(rhs.data_.GetAddress(), rhs.size_, new_data.GetAddress());
+                    std::destroy_n(data_.GetAddress(), size_);
+                    AnnotateDelete();
+                    data_.Swap(new_data);
+                    size_ = rhs.size_;
+                    AnnotateNew();
                 }
                 else {
 
                     size_t delta = rhs.size_ - size_;
                     std::copy(rhs.data_.GetAddress(), rhs.data_.GetAddress() + size_, data_.GetAddress());
                     //copy_n(rhs.data_.GetAddress(), Size(), data_.GetAddress());
+                    Annotate(size_, rhs.size_);
                     std::uninitialized_copy_n(rhs.data_.GetAddress() + size_, delta, data_.GetAddress() + size_);
                     size_ = rhs.size_;
                 }
@@ -183,6 +321,8 @@ public:
     Vector& operator=(Vector&& rhs) noexcept {
 
         if (this != &rhs) {
+            std::destroy_n(data_.GetAddress(), size_);
+            AnnotateDelete();
             size_ = 0;
             data_ = RawMemory<T>();
             Swap(rhs);
@@ -212,25 +352,23 @@ public:
         return data_[index];
     }
 
-    void Reserve(size_t new_capacity) {
-        if (new_capacity <= data_.Capacity()) {
-            return;
+#ifdef VECTOR_PROFILE_REALLOCATIONS
+    void Reserve(size_t new_capacity, CallSite site = CallSite::Current()) {
+        if (ReallocationProfiler* profiler = ReallocationProfiler::Local()) {
+            profiler->RecordReserve(site);
         }
-        RawMemory<T> new_data(new_capacity);
-        //    new_data,    data_
-      //  std::uninitialized_copy_n(data_.GetAddress(), size_, new_data.GetAddress());
-      // constexpr  if     
-        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-            std::uninitialized_move_n(data_.GetAddress(), size_, new_data.GetAddress());
-        }
-        else {
-            std::uninitialized_copy_n(data_.GetAddress(), size_, new_data.GetAddress());
-        }
-        //    data_
+        Grow(new_capacity);
+    }
+#else
+    void Reserve(size_t new_capacity) {
+        Grow(new_capacity);
+    }
+#endif
+
+    void Clear() noexcept {
         std::destroy_n(data_.GetAddress(), size_);
-        //     ,    
-        data_.Swap(new_data);
-        //          
+        Annotate(size_, 0);
+        size_ = 0;
     }
 
     void Resize(size_t new_size) {
@@ -241,9 +379,11 @@ public:
 
         if (size_ > new_size) {
             std::destroy_n(data_.GetAddress() + new_size, size_ - new_size);
+            Annotate(size_, new_size);
         }
         else {
-            Reserve(new_size);
+            Grow(new_size);
+            Annotate(size_, new_size);
             std::uninitialized_value_construct_n(data_.GetAddress() + size_, new_size - size_);
         }
         size_ = new_size;
@@ -251,58 +391,27 @@ public:
 
     template <typename S>
     void PushBack(S&& value) {
-        if (Capacity() > size_) {
-            new (data_ + size_) T(std::forward<S>(value));
-        }
-        else if (size_ == 0) {
-            Reserve(1);
-            new (data_.GetAddress()) T(std::forward<S>(value));
-        }
-        else {
-            RawMemory<T> new_data(size_ * 2);
-            new (new_data + size_) T(std::forward<S>(value));
-            if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-                std::uninitialized_move_n(data_.GetAddress(), size_, new_data.GetAddress());
-            }
-            else {
-                std::uninitialized_copy_n(data_.GetAddress(), size_, new_data.GetAddress());
-            }
-            std::destroy_n(data_.GetAddress(), size_);
-            data_.Swap(new_data);
-
-        }
-        ++size_;
+        EmplaceBack(std::forward<S>(value));
     }
 
     void PopBack() /* noexcept */ {
         T* for_del = data_.GetAddress() + size_ - 1;
         for_del->~T();
+        Annotate(size_, size_ - 1);
         size_ = size_ - 1;
     }
 
     template <typename... Args>
     T& EmplaceBack(Args&&... args) {
         if (Capacity() > size_) {
+            //    ,     ASan:
+            //           
+            Annotate(size_, size_ + 1);
             new (data_ + size_) T(std::forward<Args>(args)...);
+            ++size_;
+            return *(data_.GetAddress() + size_ - 1);
         }
-        else if (size_ == 0) {
-            Reserve(1);
-            new (data_.GetAddress()) T(std::forward<Args>(args)...);
-        }
-        else {
-            RawMemory<T> new_data(size_ * 2);
-            new (new_data + size_) T(std::forward<Args>(args)...);
-            if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-                std::uninitialized_move_n(data_.GetAddress(), size_, new_data.GetAddress());
-            }
-            else {
-                std::uninitialized_copy_n(data_.GetAddress(), size_, new_data.GetAddress());
-            }
-            std::destroy_n(data_.GetAddress(), size_);
-            data_.Swap(new_data);
-        }
-        ++size_;
-        return *(data_.GetAddress() + size_ - 1);
+        return *GrowAndEmplace(size_, std::forward<Args>(args)...);
     }
 
 
@@ -324,57 +433,104 @@ public:
             const size_t left_delta = pos - begin();
 
             if (Capacity() > size_) {
-
-                T temp = T(std::forward<Args>(args)...);
-                std::uninitialized_move_n(end() - 1, 1, end());
-                ++size_;
-                std::move_backward(begin() + left_delta, end() - 2, end() - 1);
-                iterator it_pos = begin() + left_delta;
-                *it_pos = std::move(temp);
-                return it_pos;
-            }
-
-            else {
-
-                size_t new_capacity = size_ * 2;
-                RawMemory<T> new_data(new_capacity);
-                iterator it_pos_new_data = new_data.GetAddress() + left_delta;
-                new(it_pos_new_data) T(std::forward<Args>(args)...);
-                try {
-                    if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-                        std::uninitialized_move_n(data_.GetAddress(), left_delta, new_data.GetAddress());
-                    }
-                    else {
-                        std::uninitialized_copy_n(data_.GetAddress(), left_delta, new_data.GetAddress());
-                    }
+                T* it_pos = data_ + left_delta;
+
+                // ,    ,   ,
+                //       .   
+                // (c_str() , string_view)    ,  
+                // ,        .  rvalue-
+                //     ,   Emplace(pos, id, std::move(name))
+                //         
+                if ((IsInside(args) || ...)) {
+                    T temp(std::forward<Args>(args)...);
+                    ShiftTailRight(left_delta);
+                    *it_pos = std::move(temp);
                 }
-                catch (...) {
-                    std::destroy_n(new_data + left_delta, 1);
-                    new_data.~RawMemory();
-                    throw;
+                else if constexpr (IsValueOfT<Args...>()) {
+                    ShiftTailRight(left_delta);
+                    *it_pos = (std::forward<Args>(args), ...);
                 }
-
-                try {
-                    if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-                        std::uninitialized_move_n(data_.GetAddress() + left_delta, size_ - left_delta, new_data.GetAddress() + left_delta + 1);
+                else if constexpr (!AreValues<Args...>()) {
+                    T temp(std::forward<Args>(args)...);
+                    ShiftTailRight(left_delta);
+                    *it_pos = std::move(temp);
+                }
+                else if constexpr (std::is_nothrow_constructible_v<T, Args&&...>) {
+                    ShiftTailRight(left_delta);
+                    std::destroy_at(it_pos);
+                    new (it_pos) T(std::forward<Args>(args)...);
+                }
+                else if constexpr (std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>) {
+                    ShiftTailRight(left_delta);
+                    std::destroy_at(it_pos);
+                    try {
+                        new (it_pos) T(std::forward<Args>(args)...);
                     }
-                    else {
-                        std::uninitialized_copy_n(data_.GetAddress() + left_delta, size_ - left_delta, new_data.GetAddress() + left_delta + 1);
+                    catch (...) {
+                        //    ,   
+                        new (it_pos) T(std::move(*(it_pos + 1)));
+                        std::move(it_pos + 2, data_ + size_, it_pos + 1);
+                        std::destroy_at(data_ + size_ - 1);
+                        Annotate(size_, size_ - 1);
+                        --size_;
+                        throw;
                     }
-
                 }
-                catch (...) {
-                    // std::destroy_n(new_data, left_delta);
-                    new_data.~RawMemory();
-                    throw;
+                else {
+                    T temp(std::forward<Args>(args)...);
+                    ShiftTailRight(left_delta);
+                    *it_pos = std::move(temp);
                 }
+                return MakeIterator(it_pos);
+            }
+
+            else {
+                return MakeIterator(GrowAndEmplace(left_delta, std::forward<Args>(args)...));
+            }
+        }
+    }
 
-                std::destroy_n(data_.GetAddress(), size_);
-                data_.Swap(new_data);
-                ++size_;
+    //    [first, last)       O(n + k).
+    //        .    
+    // :    ,    ,     
+    //   ,      
+    template <typename BidirIt, typename Compare = std::less<>>
+    void InsertSorted(BidirIt first, BidirIt last, Compare comp = Compare{}) {
+        const size_t count = static_cast<size_t>(std::distance(first, last));
+        if (count == 0) {
+            return;
+        }
+        using Ref = decltype(*first);
+        constexpr bool nothrow_merge = std::is_nothrow_invocable_v<Compare&, Ref, T&>
+            && std::is_nothrow_constructible_v<T, Ref> && std::is_nothrow_assignable_v<T&, Ref>
+            && std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>;
+        if (size_ + count > Capacity() || !nothrow_merge) {
+            MergeTo(first, last, count, comp);
+            return;
+        }
 
-                iterator it_pos = begin() + left_delta;
-                return it_pos;
+        T* data = data_.GetAddress();
+        size_t left = size_;
+        size_t out = size_ + count;
+        Annotate(size_, size_ + count);
+        //       
+        while (out > size_) {
+            if (left == 0 || !comp(*std::prev(last), data[left - 1])) {
+                new (data + out - 1) T(*--last);
+            }
+            else {
+                new (data + out - 1) T(std::move(data[--left]));
+            }
+            --out;
+        }
+        size_ += count;
+        //      ,     
+        while (first != last) {
+            if (left == 0 || !comp(*std::prev(last), data[left - 1])) {
+                data[--out] = *--last;
+            }
+            else {
+                data[--out] = std::move(data[--left]);
             }
         }
     }
@@ -384,6 +540,7 @@ public:
         iterator new_pos = begin() + (pos - cbegin());
         std::move(new_pos + 1, end(), new_pos);
         std::destroy_n(end() - 1, 1);
+        Annotate(size_, size_ - 1);
         --size_;
         return new_pos;
     }
@@ -410,13 +567,270 @@ public:
 
     ~Vector() {
         if (data_.GetAddress() != nullptr) {
+            RecordFinalSize();
             std::destroy_n(data_.GetAddress(), size_);
+            AnnotateDelete();
         }
     }
 
 private:
+    //       
+    template <typename U>
+    friend class ParallelVectorBuilder;
+
+    //    ;  VECTOR_PROFILE_REALLOCATIONS   
+    void ProfileGrowth() const noexcept {
+#ifdef VECTOR_PROFILE_REALLOCATIONS
+        if (ReallocationProfiler* profiler = ReallocationProfiler::Local()) {
+            profiler->RecordGrowth(origin_, size_ * sizeof(T));
+        }
+#endif
+    }
+
+    //       
+    void RecordFinalSize() const noexcept {
+#ifdef VECTOR_PROFILE_REALLOCATIONS
+        if (ReallocationProfiler* profiler = ReallocationProfiler::Local()) {
+            profiler->RecordFinalSize(origin_, size_);
+        }
+#endif
+#ifdef VECTOR_ADAPTIVE_CAPACITY
+        CapacityAdvisor::Local().RecordFinalSize(origin_, size_);
+#endif
+    }
+
+    //         
+    size_t InitialCapacity() const noexcept {
+#ifdef VECTOR_ADAPTIVE_CAPACITY
+        return std::max<size_t>(CapacityAdvisor::Local().Suggest(origin_, sizeof(T)), 1);
+#else
+        return 1;
+#endif
+    }
+
+#ifdef VECTOR_CHECKED_ITERATORS
+    iterator MakeIterator(T* ptr) noexcept {
+        return iterator(ptr, data_.Generation());
+    }
+    const_iterator MakeIterator(const T* ptr) const noexcept {
+        return const_iterator(ptr, data_.Generation());
+    }
+#else
+    static iterator MakeIterator(T* ptr) noexcept {
+        return ptr;
+    }
+    static const_iterator MakeIterator(const T* ptr) noexcept {
+        return ptr;
+    }
+#endif
+
+    //  AddressSanitizer,       [0, old_size)  [0, new_size),
+    //       .  VECTOR_ANNOTATE_CONTAINER
+    //     -fsanitize=address   
+    void Annotate([[maybe_unused]] size_t old_size, [[maybe_unused]] size_t new_size) const noexcept {
+#ifdef VECTOR_ASAN_ANNOTATIONS
+        const T* data = data_.GetAddress();
+        if (data != nullptr) {
+            __sanitizer_annotate_contiguous_container(data, data + Capacity(), data + old_size, data + new_size);
+        }
+#endif
+    }
+
+    //     :  size_  
+    void AnnotateNew() const noexcept {
+        Annotate(Capacity(), size_);
+    }
+
+    //     
+    void AnnotateDelete() const noexcept {
+        Annotate(size_, Capacity());
+    }
+
+    //      new_capacity,    
+    void Grow(size_t new_capacity) {
+        if (new_capacity <= data_.Capacity()) {
+            return;
+        }
+        ProfileGrowth();
+        RawMemory<T> new_data(new_capacity);
+        RelocateTo(new_data, size_);
+        AnnotateNew();
+    }
+
+    //    args   hole      
+    //    .   ,   args  
+    //   .     
+    template <typename... Args>
+    T* GrowAndEmplace(size_t hole, Args&&... args) {
+        ProfileGrowth();
+        RawMemory<T> new_data(size_ == 0 ? InitialCapacity() : size_ * 2);
+        new (new_data + hole) T(std::forward<Args>(args)...);
+        try {
+            RelocateTo(new_data, hole);
+        }
+        catch (...) {
+            std::destroy_at(new_data + hole);
+            throw;
+        }
+        ++size_;
+        AnnotateNew();
+        return data_ + hole;
+    }
+
+    //       [first, last)  count 
+    //   ,         .   
+    //    ,    ,    
+    //    .   ,    ,
+    //      ( T ),    
+    //  
+    template <typename BidirIt, typename Compare>
+    void MergeTo(BidirIt first, BidirIt last, size_t count, Compare& comp) {
+        constexpr bool move_copies = (std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>)
+            || !std::is_copy_constructible_v<T>;
+        constexpr bool move_own = move_copies
+            && (std::is_nothrow_invocable_v<Compare&, T&, T&> || !std::is_copy_constructible_v<T>);
+        const bool grow = size_ + count > Capacity();
+        if (grow) {
+            ProfileGrowth();
+        }
+        RawMemory<T> new_data(grow ? std::max(size_ + count, size_ * 2) : Capacity());
+        T* from = data_.GetAddress();
+        T* to = new_data.GetAddress();
+        T* copies = to + size_;
+        std::uninitialized_copy(first, last, copies);
+        size_t left = 0;
+        size_t right = 0;
+        try {
+            while (left < size_) {
+                const size_t out = left + right;
+                if (right < count && comp(copies[right], from[left])) {
+                    TransferTo<move_copies>(copies[right], to + out, out < size_);
+                    ++right;
+                }
+                else {
+                    TransferTo<move_own>(from[left], to + out, out < size_);
+                    ++left;
+                }
+            }
+        }
+        catch (...) {
+            std::destroy_n(to, std::min(left + right, size_));
+            std::destroy_n(copies, count);
+            throw;
+        }
+        if constexpr (!std::is_trivially_copyable_v<T>) {
+            std::destroy_n(from, size_);
+        }
+        AnnotateDelete();
+        data_.Swap(new_data);
+        size_ += count;
+        AnnotateNew();
+    }
+
+    //  value   to:    (raw) ,    .
+    //  Move ,  
+    template <bool Move>
+    static void TransferTo(T& value, T* to, bool raw) {
+        if constexpr (Move) {
+            if (raw) {
+                new (to) T(std::move(value));
+            }
+            else {
+                *to = std::move(value);
+            }
+        }
+        else {
+            if (raw) {
+                new (to) T(value);
+            }
+            else {
+                *to = value;
+            }
+        }
+    }
+
+    //    new_data   ,    hole
+    // ( hole == size_   ),   .  
+    //  ,    new_data  ,   
+    //    
+    void RelocateTo(RawMemory<T>& new_data, size_t hole) {
+        T* from = data_.GetAddress();
+        T* to = new_data.GetAddress();
+        size_t relocated = 0;
+        try {
+            RelocateN(from, hole, to);
+            relocated = hole;
+            RelocateN(from + hole, size_ - hole, to + hole + 1);
+        }
+        catch (...) {
+            std::destroy_n(to, relocated);
+            throw;
+        }
+        if constexpr (!std::is_trivially_copyable_v<T>) {
+            std::destroy_n(from, size_);
+        }
+        AnnotateDelete();
+        data_.Swap(new_data);
+    }
+
+    //     to  count  from:  
+    //   , ,       T
+    // ,     
+    static void RelocateN(T* from, size_t count, T* to) {
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            if (count > 0) {
+                std::memcpy(static_cast<void*>(to), from, count * sizeof(T));
+            }
+        }
+        else if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+            std::uninitialized_move_n(from, count, to);
+        }
+        else {
+            std::uninitialized_copy_n(from, count, to);
+        }
+    }
+
+    // ,    value (  )   
+    template <typename U>
+    bool IsInside(const U& value) const noexcept {
+        const auto* ptr = reinterpret_cast<const char*>(std::addressof(value));
+        const std::less<const char*> less;
+        return !less(ptr, reinterpret_cast<const char*>(data_.GetAddress()))
+            && less(ptr, reinterpret_cast<const char*>(data_.GetAddress() + size_));
+    }
+
+    // ,      T     
+    template <typename... Args>
+    static constexpr bool IsValueOfT() {
+        if constexpr (sizeof...(Args) == 1) {
+            return (std::is_same_v<std::decay_t<Args>, T> && ...) && (std::is_assignable_v<T&, Args&&> && ...);
+        }
+        else {
+            return false;
+        }
+    }
+
+    // ,       :    
+    //    ,  ,   IsInside
+    template <typename... Args>
+    static constexpr bool AreValues() {
+        return ((std::is_arithmetic_v<std::decay_t<Args>> || std::is_enum_v<std::decay_t<Args>>) && ...);
+    }
+
+    //   [pos, size_)        .
+    //   pos      
+    void ShiftTailRight(size_t pos) {
+        T* data = data_.GetAddress();
+        Annotate(size_, size_ + 1);
+        new (data + size_) T(std::move(data[size_ - 1]));
+        ++size_;
+        std::move_backward(data + pos, data + size_ - 2, data + size_ - 1);
+    }
 
     RawMemory<T> data_;
     size_t size_ = 0;
+#ifdef VECTOR_TRACK_ORIGIN
+    CallSite origin_;
+#endif
 
 };
\ No newline at end of file
@@ -0,0 +1,195 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace vector_sort_detail {
+
+    constexpr size_t RADIX_BITS = 8;
+    constexpr size_t RADIX_SIZE = size_t{ 1 } << RADIX_BITS;
+
+    // Беззнаковое целое того же размера, что и Key
+    template <typename Key>
+    using RadixKey = std::conditional_t<sizeof(Key) == 1, uint8_t,
+        std::conditional_t<sizeof(Key) == 2, uint16_t,
+        std::conditional_t<sizeof(Key) == 4, uint32_t, uint64_t>>>;
+
+    // Переводит ключ в беззнаковое целое с тем же порядком: у знаковых целых инвертируется
+    // знаковый бит, у отрицательных чисел с плавающей точкой — все биты
+    template <typename Key>
+    RadixKey<Key> ToRadixKey(Key key) noexcept {
+        static_assert(std::is_arithmetic_v<Key> && !std::is_same_v<Key, bool>,
+            "radix sort keys must be integral or floating-point");
+        using Unsigned = RadixKey<Key>;
+        constexpr Unsigned SIGN_BIT = Unsigned{ 1 } << (sizeof(Key) * 8 - 1);
+        Unsigned bits;
+        std::memcpy(&bits, &key, sizeof(Key));
+        if constexpr (std::is_floating_point_v<Key>) {
+            return (bits & SIGN_BIT) != 0 ? static_cast<Unsigned>(~bits) : static_cast<Unsigned>(bits | SIGN_BIT);
+        }
+        else if constexpr (std::is_signed_v<Key>) {
+            return static_cast<Unsigned>(bits ^ SIGN_BIT);
+        }
+        else {
+            return bits;
+        }
+    }
+
+    // Вместимость scratch доводится до size без сохранения содержимого
+    template <typename T>
+    void EnsureScratch(RawMemory<T>& scratch, size_t size) {
+        if (scratch.Capacity() < size) {
+            scratch = RawMemory<T>(size);
+        }
+    }
+
+    // Запускает task(i) для i из [0, count) в отдельных потоках и пробрасывает первое исключение
+    template <typename Task>
+    void RunParallel(size_t count, Task task) {
+        Vector<std::exception_ptr> errors(count);
+        Vector<std::thread> threads;
+        threads.Reserve(count);
+        const auto join_all = [&threads] {
+            for (std::thread& thread : threads) {
+                thread.join();
+            }
+        };
+        try {
+            for (size_t i = 0; i < count; ++i) {
+                threads.EmplaceBack([&task, &errors, i] {
+                    try {
+                        task(i);
+                    }
+                    catch (...) {
+                        errors[i] = std::current_exception();
+                    }
+                });
+            }
+        }
+        catch (...) {
+            // Не удалось создать поток: дожидаемся уже запущенных
+            join_all();
+            throw;
+        }
+        join_all();
+        for (const std::exception_ptr& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+}  // namespace vector_sort_detail
+
+// Устойчивая поразрядная (LSD) сортировка по ключу key_of(element) — целому или числу
+// с плавающей точкой. За проход распределяется один байт ключа; проходы, в которых у всех
+// ключей этот байт одинаков, пропускаются. Элементы переносятся между вектором и scratch,
+// который можно переиспользовать между вызовами, чтобы не выделять память каждый раз.
+// key_of не должен бросать исключений, NaN среди ключей с плавающей точкой не допускаются
+template <typename T, typename KeyOf>
+void RadixSortBy(Vector<T>& values, KeyOf key_of, RawMemory<T>& scratch) {
+    static_assert(std::is_nothrow_move_constructible_v<T>, "RadixSortBy requires nothrow move construction");
+    using namespace vector_sort_detail;
+    using Key = std::decay_t<std::invoke_result_t<KeyOf&, const T&>>;
+    constexpr size_t PASSES = sizeof(Key);
+
+    const size_t size = values.Size();
+    if (size < 2) {
+        return;
+    }
+    EnsureScratch(scratch, size);
+
+    // Гистограммы всех байтов ключа строятся за один проход
+    size_t counts[PASSES][RADIX_SIZE] = {};
+    for (const T& value : values) {
+        const RadixKey<Key> key = ToRadixKey(key_of(value));
+        for (size_t pass = 0; pass < PASSES; ++pass) {
+            ++counts[pass][(key >> (pass * RADIX_BITS)) & (RADIX_SIZE - 1)];
+        }
+    }
+
+    T* source = values.Data();
+    T* target = scratch.GetAddress();
+    for (size_t pass = 0; pass < PASSES; ++pass) {
+        size_t* count = counts[pass];
+        if (std::find(count, count + RADIX_SIZE, size) != count + RADIX_SIZE) {
+            continue;
+        }
+        size_t offset = 0;
+        for (size_t digit = 0; digit < RADIX_SIZE; ++digit) {
+            offset += std::exchange(count[digit], offset);
+        }
+        for (size_t i = 0; i < size; ++i) {
+            const size_t digit = (ToRadixKey(key_of(source[i])) >> (pass * RADIX_BITS)) & (RADIX_SIZE - 1);
+            new (target + count[digit]++) T(std::move(source[i]));
+        }
+        std::destroy_n(source, size);
+        std::swap(source, target);
+    }
+    // После нечётного числа проходов элементы лежат в scratch
+    if (source != values.Data()) {
+        std::uninitialized_move_n(source, size, values.Data());
+        std::destroy_n(source, size);
+    }
+}
+
+template <typename T, typename KeyOf>
+void RadixSortBy(Vector<T>& values, KeyOf key_of) {
+    RawMemory<T> scratch;
+    RadixSortBy(values, key_of, scratch);
+}
+
+// Поразрядная сортировка самих значений
+template <typename T>
+void RadixSort(Vector<T>& values, RawMemory<T>& scratch) {
+    RadixSortBy(values, [](T value) noexcept { return value; }, scratch);
+}
+
+template <typename T>
+void RadixSort(Vector<T>& values) {
+    RawMemory<T> scratch;
+    RadixSort(values, scratch);
+}
+
+// Сортирует части вектора в threads потоках через std::sort, затем попарно сливает
+// соседние части, тоже параллельно. Короткие векторы сортируются в текущем потоке.
+// При исключении в comp элементы остаются в векторе, но их порядок не определён
+template <typename T, typename Compare = std::less<>>
+void ParallelSort(Vector<T>& values, size_t threads = std::thread::hardware_concurrency(), Compare comp = {}) {
+    constexpr size_t MIN_CHUNK = size_t{ 1 } << 14;
+    const size_t size = values.Size();
+    threads = std::max<size_t>(std::min(threads, size / MIN_CHUNK), 1);
+    if (threads == 1) {
+        std::sort(values.begin(), values.end(), comp);
+        return;
+    }
+
+    // Границы частей: часть i занимает [bounds[i], bounds[i + 1])
+    Vector<size_t> bounds(threads + 1);
+    for (size_t i = 0; i <= threads; ++i) {
+        bounds[i] = size * i / threads;
+    }
+    T* data = values.Data();
+    vector_sort_detail::RunParallel(threads, [&](size_t i) {
+        std::sort(data + bounds[i], data + bounds[i + 1], comp);
+    });
+    for (size_t width = 1; width < threads; width *= 2) {
+        const size_t merges = (threads + 2 * width - 1) / (2 * width);
+        vector_sort_detail::RunParallel(merges, [&](size_t i) {
+            const size_t first = 2 * width * i;
+            const size_t middle = std::min(first + width, threads);
+            const size_t last = std::min(first + 2 * width, threads);
+            if (middle < last) {
+                std::inplace_merge(data + bounds[first], data + bounds[middle], data + bounds[last], comp);
+            }
+        });
+    }
+}